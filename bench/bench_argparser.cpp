@@ -0,0 +1,1362 @@
+//
+// Benchmarks for the ArgParser
+//
+// Build with optimizations:
+//      cmake -DCMAKE_BUILD_TYPE=Release ..
+//      make argparser_bench
+//      ./argparser_bench
+//
+// Options:
+//      --max-tokens <n>    largest synthetic argv for the shape benchmarks (default: 1000000)
+//      --response-mb <n>   size of the generated response file (default: 64)
+//
+// The shape benchmarks time every public API on synthetic command lines against getopt_long as baseline
+// and report ns/token and heap allocations per call.
+//
+#include "ArgParser.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+
+//
+// Count heap allocations through a replaced operator new, all forms of it so new/delete pairs always match
+//
+static size_t glb_nAllocations = 0;
+
+// Every form of operator new ends up here, and every operator delete in std::free
+static void *CountedAlloc(size_t sz, size_t alignment = 0) {
+    glb_nAllocations++;
+    if (sz == 0) {
+        sz = 1;
+    }
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (sz + alignment - 1) / alignment * alignment);
+    }
+    return std::malloc(sz);
+}
+static void *CountedAllocOrThrow(size_t sz, size_t alignment = 0) {
+    if (void *ptr = CountedAlloc(sz, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void *operator new(size_t sz) {
+    return CountedAllocOrThrow(sz);
+}
+void *operator new[](size_t sz) {
+    return CountedAllocOrThrow(sz);
+}
+void *operator new(size_t sz, std::align_val_t al) {
+    return CountedAllocOrThrow(sz, static_cast<size_t>(al));
+}
+void *operator new[](size_t sz, std::align_val_t al) {
+    return CountedAllocOrThrow(sz, static_cast<size_t>(al));
+}
+void *operator new(size_t sz, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz);
+}
+void *operator new[](size_t sz, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz);
+}
+void *operator new(size_t sz, std::align_val_t al, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz, static_cast<size_t>(al));
+}
+void *operator new[](size_t sz, std::align_val_t al, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz, static_cast<size_t>(al));
+}
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+// Synthetic command line - owns the strings and the argv array pointing into them
+struct SyntheticArgs {
+    std::vector<std::string> strings;
+    std::vector<const char *> argv;
+
+    void Finalize() {
+        argv.clear();
+        for(auto &s : strings) {
+            argv.push_back(s.c_str());
+        }
+    }
+};
+
+// Options at the front followed by a large list of input files, like: 'app -o0 v0 -o1 v1 ... file0 file1 ...'
+static SyntheticArgs MakeFileListArgs(size_t nOptions, size_t nFiles) {
+    SyntheticArgs synth;
+    synth.strings.emplace_back("prgname.exe");
+    for(size_t i=0;i<nOptions;i++) {
+        synth.strings.emplace_back("--option" + std::to_string(i));
+        synth.strings.emplace_back(std::to_string(i));
+    }
+    for(size_t i=0;i<nFiles;i++) {
+        synth.strings.emplace_back("path/to/input_file_" + std::to_string(i) + ".dat");
+    }
+    synth.Finalize();
+    return synth;
+}
+
+template<typename TFunc>
+static double MeasureNs(size_t nIterations, TFunc func) {
+    auto tStart = std::chrono::steady_clock::now();
+    for(size_t i=0;i<nIterations;i++) {
+        func();
+    }
+    auto tEnd = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(tEnd - tStart).count() / static_cast<double>(nIterations);
+}
+
+struct Measurement {
+    double ns = 0;
+    double nAllocations = 0;
+};
+
+// Same as MeasureNs but also counting allocations per iteration
+template<typename TFunc>
+static Measurement Measure(size_t nIterations, TFunc func) {
+    auto nAllocsBefore = glb_nAllocations;
+    Measurement m;
+    m.ns = MeasureNs(nIterations, func);
+    m.nAllocations = static_cast<double>(glb_nAllocations - nAllocsBefore) / static_cast<double>(nIterations);
+    return m;
+}
+
+// Query cost with and without the index as argc grows
+static void BenchIndexScaling() {
+    static const size_t nOptions = 200;
+    std::vector<std::string> shortNames;
+    std::vector<std::string> longNames;
+    for(size_t i=0;i<nOptions;i++) {
+        // short names are never present, every other long name is missing - forces a scan across all of argv
+        shortNames.emplace_back("-" + std::string(1, static_cast<char>('A' + (i % 26))));
+        longNames.emplace_back(((i & 1) ? "--missing" : "--option") + std::to_string(i));
+    }
+
+    printf("Index scaling - %zu queries per parse\n", nOptions);
+    printf("%10s %16s %16s %16s\n", "argc", "scan ns/query", "index ns/query", "build ns");
+    for(size_t nFiles : {10, 100, 1000, 10000, 50000}) {
+        auto synth = MakeFileListArgs(nOptions, nFiles);
+        size_t nIterations = std::max<size_t>(1, 200000 / synth.argv.size());
+
+        volatile int sink = 0;
+        ArgParser argParserScan(synth.argv.size(), synth.argv.data());
+        auto nsScan = MeasureNs(nIterations, [&]() {
+            for(size_t i=0;i<nOptions;i++) {
+                sink = sink + *argParserScan.TryParse(0, shortNames[i], longNames[i]);
+            }
+        });
+
+        auto nsBuild = MeasureNs(nIterations, [&]() {
+            ArgParser argParser(synth.argv.size(), synth.argv.data());
+            argParser.BuildIndex();
+        });
+
+        ArgParser argParserIndex(synth.argv.size(), synth.argv.data());
+        argParserIndex.BuildIndex();
+        auto nsIndex = MeasureNs(nIterations, [&]() {
+            for(size_t i=0;i<nOptions;i++) {
+                sink = sink + *argParserIndex.TryParse(0, shortNames[i], longNames[i]);
+            }
+        });
+
+        printf("%10zu %16.1f %16.1f %16.1f\n", synth.argv.size(), nsScan / nOptions, nsIndex / nOptions, nsBuild);
+    }
+    printf("\n");
+}
+
+// Response file expansion throughput compared to plain memory copy of the same size
+static void BenchResponseFile(size_t nMegaBytes) {
+    char filename[] = "/tmp/argparser_benchXXXXXX";
+    int fd = mkstemp(filename);
+    if (fd < 0) {
+        printf("Response file - unable to create temporary file\n\n");
+        return;
+    }
+
+    // Mix of plain paths and a few quoted ones
+    size_t szTarget = nMegaBytes * 1024 * 1024;
+    size_t szWritten = 0;
+    std::string chunk;
+    for(size_t i=0;szWritten < szTarget;i++) {
+        chunk.clear();
+        for(size_t j=0;j<1024;j++,i++) {
+            if ((i % 64) == 0) {
+                chunk += "\"path/with spaces/input_file_" + std::to_string(i) + ".dat\"\n";
+            } else {
+                chunk += "path/to/some/input_file_" + std::to_string(i) + ".dat\n";
+            }
+        }
+        if (write(fd, chunk.data(), chunk.size()) != (ssize_t)chunk.size()) {
+            break;
+        }
+        szWritten += chunk.size();
+    }
+    close(fd);
+
+    std::string rspArg = std::string("@") + filename;
+    const char *argv[] = { "prgname.exe", rspArg.c_str() };
+
+    size_t nArgs = 0;
+    auto nsExpand = MeasureNs(3, [&]() {
+        ArgResponseFile responseFile;
+        responseFile.Open(filename);
+        nArgs = responseFile.Tokens().size();
+    });
+    auto nsParser = MeasureNs(3, [&]() {
+        ArgParser argParser(2, argv);
+        argParser.ExpandResponseFiles();
+    });
+
+    std::vector<char> src(szWritten, 'a');
+    std::vector<char> dst(szWritten);
+    auto nsCopy = MeasureNs(3, [&]() {
+        memcpy(dst.data(), src.data(), src.size());
+    });
+    unlink(filename);
+
+    auto mb = static_cast<double>(szWritten) / (1024.0 * 1024.0);
+    printf("Response file - %.1f MB, %zu arguments\n", mb, nArgs);
+    printf("  map + tokenize:    %8.1f MB/s\n", mb / (nsExpand * 1e-9));
+    printf("  parser expand:     %8.1f MB/s\n", mb / (nsParser * 1e-9));
+    printf("  memcpy baseline:   %8.1f MB/s\n", mb / (nsCopy * 1e-9));
+    printf("\n");
+}
+
+// Delimited list parsing, 100k shard ids in one argument, compared to a char by char split
+static void BenchList() {
+    static const size_t nIds = 100000;
+    std::string ids;
+    for(size_t i=0;i<nIds;i++) {
+        if (i) ids += ",";
+        ids += std::to_string(i * 7919);
+    }
+    const char *argv[] = { "prgname.exe", "--ids", ids.c_str() };
+
+    std::vector<uint64_t> values;
+    auto nsList = MeasureNs(20, [&]() {
+        ArgParser argParser(3, argv);
+        values.clear();
+        argParser.TryParseList(values, "", "--ids");
+    });
+
+    auto nsNaive = MeasureNs(20, [&]() {
+        ArgParser argParser(3, argv);
+        auto list = *argParser.TryParse<std::string>("", "--ids");
+        values.clear();
+        std::string current;
+        for(auto ch : list) {
+            if (ch == ',') {
+                values.push_back(std::stoull(current));
+                current.clear();
+            } else {
+                current.push_back(ch);
+            }
+        }
+        values.push_back(std::stoull(current));
+    });
+
+    printf("List - %zu ids, %zu bytes\n", nIds, ids.size());
+    printf("  TryParseList:    %8.2f ns/id\n", nsList / nIds);
+    printf("  char by char:    %8.2f ns/id\n", nsNaive / nIds);
+    printf("\n");
+}
+
+//
+// Synthetic command line shapes
+//
+enum class kShape {
+    Flags,              // --flag0 --flag1 ... (cycling over 64 distinct flags)
+    BundledFlags,       // -abcdefgh -ijklmnop ...
+    LongValues,         // --opt0 value0 --opt1 value1 ...
+    PositionalTail,     // -v -o out.file file0 file1 file2 ...
+};
+
+static const char *ShapeName(kShape shape) {
+    switch(shape) {
+        case kShape::Flags : return "flags";
+        case kShape::BundledFlags : return "bundled";
+        case kShape::LongValues : return "long values";
+        case kShape::PositionalTail : return "positional";
+    }
+    return "";
+}
+
+static constexpr size_t kDistinctOptions = 64;
+static const char *kBundleLetters = "abcdefghijklmnopqrstuvwxyzABCDEF";
+
+static SyntheticArgs MakeShapeArgs(kShape shape, size_t nTokens) {
+    SyntheticArgs synth;
+    synth.strings.reserve(nTokens + 1);
+    synth.strings.emplace_back("prgname.exe");
+    size_t i = 0;
+    while(synth.strings.size() <= nTokens) {
+        switch(shape) {
+            case kShape::Flags :
+                synth.strings.emplace_back("--flag" + std::to_string(i % kDistinctOptions));
+                break;
+            case kShape::BundledFlags :
+                synth.strings.emplace_back("-" + std::string(kBundleLetters + (i % 4) * 8, 8));
+                break;
+            case kShape::LongValues :
+                synth.strings.emplace_back("--opt" + std::to_string(i % kDistinctOptions));
+                synth.strings.emplace_back(std::to_string(i));
+                break;
+            case kShape::PositionalTail :
+                if (i == 0) {
+                    synth.strings.emplace_back("-v");
+                    synth.strings.emplace_back("-o");
+                    synth.strings.emplace_back("out.file");
+                } else {
+                    synth.strings.emplace_back("path/to/input_file_" + std::to_string(i) + ".dat");
+                }
+                break;
+        }
+        i++;
+    }
+    synth.Finalize();
+    return synth;
+}
+
+// getopt_long baseline - a full parse of argv with an option table matching the shape
+static int ParseGetOpt(kShape shape, std::vector<char *> &argvCopy, const SyntheticArgs &synth, const std::vector<option> &longOptions) {
+    // getopt permutes argv, work on a fresh copy of the pointers each time
+    for(size_t i=0;i<synth.argv.size();i++) {
+        argvCopy[i] = const_cast<char *>(synth.argv[i]);
+    }
+    optind = 0;
+    opterr = 0;
+    const char *shortOptions = (shape == kShape::PositionalTail) ? "vo:" : "abcdefghijklmnopqrstuvwxyzABCDEF";
+    int nFound = 0;
+    int ch;
+    while((ch = getopt_long(static_cast<int>(synth.argv.size()), argvCopy.data(), shortOptions, longOptions.data(), nullptr)) != -1) {
+        nFound++;
+    }
+    return nFound;
+}
+
+static std::vector<option> MakeGetOptTable(kShape shape, std::vector<std::string> &names) {
+    std::vector<option> longOptions;
+    for(size_t i=0;i<kDistinctOptions;i++) {
+        auto &name = names.emplace_back((shape == kShape::LongValues ? "opt" : "flag") + std::to_string(i));
+        (void)name;
+    }
+    for(size_t i=0;i<kDistinctOptions;i++) {
+        longOptions.push_back({names[i].c_str(), (shape == kShape::LongValues) ? required_argument : no_argument, nullptr, static_cast<int>(256 + i)});
+    }
+    longOptions.push_back({nullptr, 0, nullptr, 0});
+    return longOptions;
+}
+
+static void PrintMeasurement(const char *api, size_t nTokens, const Measurement &m) {
+    printf("  %-28s %12.2f ns/token %12.1f ns/call %10.1f allocs/call\n", api, m.ns / static_cast<double>(nTokens), m.ns, m.nAllocations);
+}
+
+static void BenchShape(kShape shape, size_t nTokens) {
+    auto synth = MakeShapeArgs(shape, nTokens);
+    auto argc = synth.argv.size();
+    auto argv = synth.argv.data();
+    size_t nIterations = std::max<size_t>(3, 2000000 / argc);
+    volatile int sink = 0;
+
+    // names to query, covering all distinct options of the shape
+    std::vector<std::string> shortNames;
+    std::vector<std::string> longNames;
+    for(size_t i=0;i<kDistinctOptions;i++) {
+        shortNames.emplace_back("-" + std::string(1, kBundleLetters[i % 32]));
+        longNames.emplace_back(((shape == kShape::LongValues) ? "--opt" : "--flag") + std::to_string(i));
+    }
+
+    printf("Shape: %s, %zu tokens\n", ShapeName(shape), argc - 1);
+
+    std::vector<std::string> getoptNames;
+    auto longOptions = MakeGetOptTable(shape, getoptNames);
+    std::vector<char *> argvCopy(argc + 1, nullptr);
+    PrintMeasurement("getopt_long (full parse)", argc, Measure(nIterations, [&]() {
+        sink = sink + ParseGetOpt(shape, argvCopy, synth, longOptions);
+    }));
+
+    // a full parse with the ArgParser is one query per distinct option
+    PrintMeasurement("ArgParser (full parse)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        for(size_t i=0;i<kDistinctOptions;i++) {
+            sink = sink + (argParser.IsPresent(shortNames[i], longNames[i]) ? 1 : 0);
+        }
+    }));
+    PrintMeasurement("ArgParser (indexed parse)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        argParser.BuildIndex();
+        for(size_t i=0;i<kDistinctOptions;i++) {
+            sink = sink + (argParser.IsPresent(shortNames[i], longNames[i]) ? 1 : 0);
+        }
+    }));
+
+    PrintMeasurement("ArgParser (parse+Unconsumed)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        for(size_t i=0;i<kDistinctOptions;i++) {
+            sink = sink + (argParser.IsPresent(shortNames[i], longNames[i]) ? 1 : 0);
+        }
+        std::vector<std::string_view> unconsumed;
+        sink = sink + argParser.Unconsumed(unconsumed);
+    }));
+
+    // individual API calls, each on a fresh parser
+    PrintMeasurement("ctor", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + argParser.IsLastArgument("-x");
+    }));
+    PrintMeasurement("BuildIndex", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        argParser.BuildIndex();
+    }));
+    PrintMeasurement("IsPresent (missing)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + argParser.IsPresent("-Z", "--missing");
+    }));
+    PrintMeasurement("TryParse<int> (missing)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + *argParser.TryParse(0, "-Z", "--missing");
+    }));
+    PrintMeasurement("TryParse<string> (missing)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + argParser.TryParse(std::string("default"), "-Z", "--missing")->size();
+    }));
+    PrintMeasurement("TryParse<vector> (missing)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<int> values;
+        sink = sink + argParser.TryParse(values, "-Z", "--missing");
+    }));
+    PrintMeasurement("TryParseList (missing)", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<int> values;
+        sink = sink + argParser.TryParseList(values, "-Z", "--missing");
+    }));
+    PrintMeasurement("CountPresence", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + argParser.CountPresence("-a", longNames[0]);
+    }));
+    PrintMeasurement("IsLastArgument", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        sink = sink + argParser.IsLastArgument("-o", longNames[0]);
+    }));
+    PrintMeasurement("CopyEndArgs<string>", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<std::string> values;
+        sink = sink + argParser.CopyEndArgs(values);
+    }));
+    PrintMeasurement("CopyEndArgs<string_view>", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<std::string_view> values;
+        sink = sink + argParser.CopyEndArgs(values);
+    }));
+    PrintMeasurement("EndArgs<string_view>", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        for(auto value : argParser.EndArgs<std::string_view>()) {
+            sink = sink + static_cast<int>(value->size());
+        }
+    }));
+    PrintMeasurement("Values<string_view>", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        for(auto value : argParser.Values<std::string_view>("-o", longNames[0])) {
+            sink = sink + static_cast<int>(value->size());
+        }
+    }));
+    PrintMeasurement("CopyAllAfter", argc, Measure(nIterations, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<std::string> values;
+        sink = sink + argParser.CopyAllAfter(values, "prgname.exe");
+    }));
+    printf("\n");
+}
+
+static void BenchShapes(size_t maxTokens) {
+    for(auto shape : {kShape::Flags, kShape::BundledFlags, kShape::LongValues, kShape::PositionalTail}) {
+        for(size_t nTokens = 10; nTokens <= maxTokens; nTokens *= 10) {
+            BenchShape(shape, nTokens);
+        }
+    }
+}
+
+// Admin commands arriving at a high rate - a new parser per command versus one parser that is Reset per command
+static void BenchReset() {
+    static const size_t nCommands = 1000;
+    std::vector<SyntheticArgs> commands;
+    for(size_t i=0;i<nCommands;i++) {
+        SyntheticArgs synth;
+        synth.strings = {"set", "--key", "some.config.key." + std::to_string(i), "--value", std::to_string(i), "-v", "--", "trailing"};
+        synth.Finalize();
+        commands.push_back(std::move(synth));
+    }
+
+    volatile size_t sink = 0;
+    auto cbQueries = [&sink](ArgParser &argParser) {
+        sink = sink + argParser.TryParse(std::string_view{}, "-k", "--key")->size();
+        sink = sink + *argParser.TryParse(0, "", "--value");
+        sink = sink + argParser.IsPresent("-v", "--verbose");
+    };
+
+    auto mNew = Measure(100, [&]() {
+        for(auto &command : commands) {
+            ArgParser argParser(command.argv.size(), command.argv.data());
+            argParser.SetStopCondition("--");
+            argParser.BuildIndex();
+            cbQueries(argParser);
+        }
+    });
+
+    ArgParser argParser(commands[0].argv.size(), commands[0].argv.data());
+    argParser.SetStopCondition("--");
+    argParser.BuildIndex();
+    auto mReset = Measure(100, [&]() {
+        for(auto &command : commands) {
+            argParser.Reset(command.argv.size(), command.argv.data());
+            cbQueries(argParser);
+        }
+    });
+
+    printf("Reset - %zu commands, indexed\n", nCommands);
+    printf("  new parser:      %8.1f ns/command %6.2f allocs/command\n", mNew.ns / nCommands, mNew.nAllocations / nCommands);
+    printf("  Reset:           %8.1f ns/command %6.2f allocs/command\n", mReset.ns / nCommands, mReset.nAllocations / nCommands);
+    printf("\n");
+}
+
+// Millions of numeric ids as end arguments, converted on an increasing number of threads
+static void BenchEndArgsParallel() {
+    static const size_t nIds = 4000000;
+    SyntheticArgs synth;
+    synth.strings.reserve(nIds + 2);
+    synth.strings.emplace_back("prgname");
+    synth.strings.emplace_back("-v");
+    for(size_t i=0;i<nIds;i++) {
+        synth.strings.emplace_back(std::to_string(1000000000000ull + i * 7919));
+    }
+    synth.Finalize();
+    ArgParser argParser(synth.argv.size(), synth.argv.data());
+
+    volatile size_t sink = 0;
+    printf("CopyEndArgsParallel - %zu ids, %u cores\n", nIds, std::thread::hardware_concurrency());
+    auto mSequential = Measure(5, [&]() {
+        std::vector<uint64_t> ids;
+        sink = sink + argParser.CopyEndArgs(ids);
+    });
+    PrintMeasurement("CopyEndArgs<uint64_t>", nIds, mSequential);
+    size_t maxThreads = std::max(8u, std::thread::hardware_concurrency());
+    for(size_t nThreads=1;nThreads<=maxThreads;nThreads*=2) {
+        auto m = Measure(5, [&]() {
+            std::vector<uint64_t> ids;
+            sink = sink + argParser.CopyEndArgsParallel(ids, true, nThreads);
+        });
+        char name[64];
+        snprintf(name, sizeof(name), "parallel, %zu threads", nThreads);
+        PrintMeasurement(name, nIds, m);
+    }
+    printf("\n");
+}
+
+// Cost of failing queries: silent, a counting sink and the classic stderr messages (sent to /dev/null)
+static void BenchDiagnostics() {
+    static const size_t nOptions = 64;
+    SyntheticArgs synth;
+    synth.strings.emplace_back("prgname");
+    std::vector<std::string> names;
+    for(size_t i=0;i<nOptions;i++) {
+        names.emplace_back("--opt" + std::to_string(i));
+        synth.strings.emplace_back(names.back());
+        synth.strings.emplace_back("not-a-number");
+    }
+    synth.Finalize();
+    ArgParser argParser(synth.argv.size(), synth.argv.data());
+
+    volatile size_t sink = 0;
+    auto cbQueries = [&]() {
+        for(auto &name : names) {
+            sink = sink + argParser.TryParse(0, "", name).has_value();
+        }
+    };
+    auto mSilent = Measure(10000, cbQueries);
+    size_t nReported = 0;
+    argParser.SetDiagnostics([](void *context, const ArgParser::ArgError &) {
+        (*static_cast<size_t *>(context))++;
+    }, &nReported);
+    auto mCounting = Measure(10000, cbQueries);
+
+    fflush(stderr);
+    auto fdSaved = dup(2);
+    auto fdNull = open("/dev/null", O_WRONLY);
+    dup2(fdNull, 2);
+    argParser.SetDiagnostics(ArgParser::ArgDiagnostics::Stderr);
+    auto mStderr = Measure(10000, cbQueries);
+    fflush(stderr);
+    dup2(fdSaved, 2);
+    close(fdNull);
+    close(fdSaved);
+
+    printf("Diagnostics - %zu failing queries\n", nOptions);
+    PrintMeasurement("no sink", synth.argv.size(), mSilent);
+    PrintMeasurement("counting sink", synth.argv.size(), mCounting);
+    PrintMeasurement("ArgDiagnostics::Stderr", synth.argv.size(), mStderr);
+    printf("\n");
+}
+
+// User type converters (sizes, durations) straight from argv vs. parsing into a std::string and converting that
+static void BenchConverters() {
+    static const size_t nOptions = 64;
+    SyntheticArgs synth;
+    synth.strings.emplace_back("prgname");
+    std::vector<std::string> sizeNames, durationNames;
+    for(size_t i=0;i<nOptions;i++) {
+        sizeNames.emplace_back("--size" + std::to_string(i));
+        synth.strings.emplace_back(sizeNames.back());
+        synth.strings.emplace_back(std::to_string(i + 1) + "M");
+        durationNames.emplace_back("--timeout" + std::to_string(i));
+        synth.strings.emplace_back(durationNames.back());
+        synth.strings.emplace_back(std::to_string(i) + "m" + std::to_string(i) + "s");
+    }
+    synth.Finalize();
+    ArgParser argParser(synth.argv.size(), synth.argv.data());
+    argParser.BuildIndex();
+
+    volatile uint64_t sink = 0;
+    auto mString = Measure(10000, [&]() {
+        // what callers had to do before: copy into a string and convert by hand
+        for(size_t i=0;i<nOptions;i++) {
+            auto size = argParser.TryParse(std::string{}, "", sizeNames[i]);
+            auto multiplier = (size->back() == 'M') ? (1ull << 20) : 1ull;
+            sink = sink + std::stoull(size->substr(0, size->size() - 1)) * multiplier;
+            auto duration = argParser.TryParse(std::string{}, "", durationNames[i]);
+            auto idxM = duration->find('m');
+            sink = sink + std::stoull(duration->substr(0, idxM)) * 60 + std::stoull(duration->substr(idxM + 1));
+        }
+    });
+    auto mConverter = Measure(10000, [&]() {
+        for(size_t i=0;i<nOptions;i++) {
+            sink = sink + *argParser.TryParse(ArgByteSize{}, "", sizeNames[i]);
+            sink = sink + argParser.TryParse(std::chrono::seconds{}, "", durationNames[i])->count();
+        }
+    });
+
+    printf("Converters - %zu sizes and %zu durations\n", nOptions, nOptions);
+    PrintMeasurement("std::string + manual", synth.argv.size(), mString);
+    PrintMeasurement("ArgConverter", synth.argv.size(), mConverter);
+    printf("\n");
+}
+
+// Number conversion, the in-house parsers against std::from_chars and the C library
+static void BenchNumbers() {
+    static const size_t nValues = 100000;
+    std::vector<std::string> doubles, shortDoubles, integers;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    auto cbNext = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    char buffer[64];
+    for(size_t i=0;i<nValues;i++) {
+        double x;
+        do {
+            x = std::bit_cast<double>(cbNext());
+        } while(!std::isfinite(x));
+        snprintf(buffer, sizeof(buffer), "%.17g", x);
+        doubles.emplace_back(buffer);
+        snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(cbNext() % 100000) / 7.0);
+        shortDoubles.emplace_back(buffer);
+        integers.emplace_back(std::to_string(static_cast<int64_t>(cbNext() >> (cbNext() % 64))));
+    }
+
+    auto cbBench = [](const char *name, const std::vector<std::string> &values, auto parse) {
+        volatile double sink = 0;
+        auto m = Measure(10, [&]() {
+            for(auto &str : values) {
+                sink = sink + parse(str.data(), str.data() + str.size());
+            }
+        });
+        PrintMeasurement(name, values.size(), m);
+    };
+
+    printf("Number parsing - %zu values\n", nValues);
+    for(auto [label, values] : {std::pair{"%.17g doubles", &doubles}, std::pair{"%.3f doubles", &shortDoubles}}) {
+        printf("  %s\n", label);
+        cbBench("std::from_chars<double>", *values, [](const char *first, const char *last) {
+            double v = 0;
+            std::from_chars(first, last, v);
+            return v;
+        });
+        cbBench("strtod", *values, [](const char *first, const char *) {
+            return strtod(first, nullptr);
+        });
+        cbBench("ParseFloat<double>", *values, [](const char *first, const char *last) {
+            double v = 0;
+            ArgNumberParser::ParseFloat(first, last, v);
+            return v;
+        });
+        cbBench("ParseFloat<float>", *values, [](const char *first, const char *last) {
+            float v = 0;
+            ArgNumberParser::ParseFloat(first, last, v);
+            return static_cast<double>(v);
+        });
+    }
+    printf("  int64 values\n");
+    cbBench("std::from_chars<int64_t>", integers, [](const char *first, const char *last) {
+        int64_t v = 0;
+        std::from_chars(first, last, v);
+        return static_cast<double>(v);
+    });
+    cbBench("strtoll", integers, [](const char *first, const char *) {
+        return static_cast<double>(strtoll(first, nullptr, 10));
+    });
+    cbBench("ParseInteger<int64_t>", integers, [](const char *first, const char *last) {
+        int64_t v = 0;
+        ArgNumberParser::ParseInteger(first, last, v);
+        return static_cast<double>(v);
+    });
+    printf("\n");
+}
+
+// Attached values ('--name=value') parsed in place vs. rewriting argv into separate arguments first
+static void BenchAttached() {
+    static const size_t nOptions = 64;
+    SyntheticArgs synth;
+    synth.strings.emplace_back("prgname");
+    std::vector<std::string> longNames;
+    for(size_t i=0;i<nOptions;i++) {
+        longNames.emplace_back("--opt" + std::to_string(i));
+        synth.strings.emplace_back(longNames.back() + "=" + std::to_string(i));
+    }
+    synth.Finalize();
+    auto argc = synth.argv.size();
+    auto argv = synth.argv.data();
+
+    volatile int sink = 0;
+    auto mRewrite = Measure(10000, [&]() {
+        // what a wrapper had to do before: split every '--name=value' into two new strings
+        std::vector<std::string> strings;
+        std::vector<const char *> splitArgv;
+        strings.reserve(argc * 2);
+        for(size_t i=0;i<argc;i++) {
+            std::string_view arg = argv[i];
+            auto idx = arg.find('=');
+            if (!arg.starts_with("--") || (idx == std::string_view::npos)) {
+                strings.emplace_back(arg);
+                continue;
+            }
+            strings.emplace_back(arg.substr(0, idx));
+            strings.emplace_back(arg.substr(idx + 1));
+        }
+        for(auto &str : strings) {
+            splitArgv.push_back(str.c_str());
+        }
+        ArgParser argParser(splitArgv.size(), splitArgv.data());
+        for(auto &name : longNames) {
+            sink = sink + *argParser.TryParse(0, "", name);
+        }
+    });
+    auto mAttached = Measure(10000, [&]() {
+        ArgParser argParser(argc, argv);
+        for(auto &name : longNames) {
+            sink = sink + *argParser.TryParse(0, "", name);
+        }
+    });
+
+    printf("Attached values - %zu '--name=value' options\n", nOptions);
+    PrintMeasurement("rewrite argv + TryParse", argc, mRewrite);
+    PrintMeasurement("TryParse (attached)", argc, mAttached);
+    printf("\n");
+}
+
+// Compiler style repeated options, like a code generator passing thousands of '-D' definitions
+static void BenchAccumulate() {
+    static const size_t nDefines = 20000;
+    SyntheticArgs synth;
+    synth.strings.emplace_back("prgname");
+    for(size_t i=0;i<nDefines;i++) {
+        synth.strings.emplace_back("-D");
+        synth.strings.emplace_back("GENERATED_SYMBOL_" + std::to_string(i) + "=" + std::to_string(i));
+        if ((i % 100) == 0) {
+            synth.strings.emplace_back("-I");
+            synth.strings.emplace_back("include/dir" + std::to_string(i));
+        }
+    }
+    synth.strings.emplace_back("output.c");
+    synth.Finalize();
+    auto argc = synth.argv.size();
+    auto argv = synth.argv.data();
+
+    volatile size_t sink = 0;
+    std::vector<char *> argvCopy(argc + 1, nullptr);
+    static const option longOptions[] = {
+        {"define", required_argument, nullptr, 'D'},
+        {"include", required_argument, nullptr, 'I'},
+        {nullptr, 0, nullptr, 0},
+    };
+    auto mGetOpt = Measure(100, [&]() {
+        for(size_t i=0;i<argc;i++) {
+            argvCopy[i] = const_cast<char *>(argv[i]);
+        }
+        optind = 0;
+        opterr = 0;
+        std::vector<std::pair<std::string_view, std::string_view>> defines;
+        int ch;
+        while((ch = getopt_long(static_cast<int>(argc), argvCopy.data(), "D:I:", longOptions, nullptr)) != -1) {
+            if (ch != 'D') continue;
+            std::string_view definition = optarg;
+            auto idx = definition.find('=');
+            defines.emplace_back(definition.substr(0, idx), (idx == std::string_view::npos) ? std::string_view{} : definition.substr(idx + 1));
+        }
+        sink = sink + defines.size();
+    });
+    auto mMap = Measure(100, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<std::pair<std::string_view, std::string_view>> defines;
+        sink = sink + argParser.TryParseMap(defines, "-D", "--define");
+    });
+    auto mMapIndexed = Measure(100, [&]() {
+        ArgParser argParser(argc, argv);
+        argParser.BuildIndex();
+        std::vector<std::pair<std::string_view, std::string_view>> defines;
+        sink = sink + argParser.TryParseMap(defines, "-D", "--define");
+    });
+    auto mAll = Measure(100, [&]() {
+        ArgParser argParser(argc, argv);
+        std::vector<std::string_view> includes;
+        sink = sink + argParser.TryParseAll(includes, "-I", "--include");
+    });
+    // a compiler driver asks for more than the definitions, the index is built once for all of its queries
+    static const char *kDriverOptions[] = {
+        "--output", "--std", "--target", "--sysroot", "--optimize", "--debug", "--warnings", "--werror",
+        "--language", "--compile-only", "--preprocess", "--assemble", "--pic", "--shared", "--static", "--verbose",
+    };
+    auto driverQueries = [&](ArgParser &argParser) {
+        std::vector<std::pair<std::string_view, std::string_view>> defines;
+        std::vector<std::string_view> includes;
+        sink = sink + argParser.TryParseMap(defines, "-D", "--define");
+        sink = sink + argParser.TryParseAll(includes, "-I", "--include");
+        for(auto name : kDriverOptions) {
+            sink = sink + argParser.IsPresent("", name);
+        }
+    };
+    auto mDriver = Measure(100, [&]() {
+        ArgParser argParser(argc, argv);
+        driverQueries(argParser);
+    });
+    auto mDriverIndexed = Measure(100, [&]() {
+        ArgParser argParser(argc, argv);
+        argParser.BuildIndex();
+        driverQueries(argParser);
+    });
+
+    printf("Accumulate - %zu '-D' definitions, %zu tokens\n", nDefines, argc - 1);
+    PrintMeasurement("getopt_long (-D map)", argc, mGetOpt);
+    PrintMeasurement("TryParseMap", argc, mMap);
+    PrintMeasurement("TryParseMap (+ BuildIndex)", argc, mMapIndexed);
+    PrintMeasurement("TryParseAll<string_view>", argc, mAll);
+    PrintMeasurement("driver (map, all, 16 flags)", argc, mDriver);
+    PrintMeasurement("driver (indexed)", argc, mDriverIndexed);
+    printf("\n");
+}
+
+// Short flag queries on wide bundles ('-vvvvxzf'), answered from the bitset vs. scanning argv
+static void BenchShortFlags() {
+    static const char *kBundles[] = {"-vvvvxzf", "-abcdefgh", "-qwertyu", "-zxcvbnm"};
+    static const char *kQueries[] = {"-v", "-x", "-f", "-k", "-m", "-Q"};
+    printf("Short flags - wide bundles, %zu queries per parse\n", std::size(kQueries));
+    for(size_t nTokens : {10, 100, 1000, 10000}) {
+        SyntheticArgs synth;
+        for(size_t i=0;i<nTokens;i++) {
+            synth.strings.emplace_back(kBundles[i % std::size(kBundles)]);
+        }
+        synth.Finalize();
+        size_t nIterations = std::max<size_t>(10, 1000000 / nTokens);
+
+        volatile int sink = 0;
+        // The long name is never present, it only forces the linear scan with identical results
+        auto mScan = Measure(nIterations, [&]() {
+            ArgParser argParser(synth.argv.size(), synth.argv.data());
+            for(auto query : kQueries) {
+                sink = sink + argParser.IsPresent(query, "--not-present") + argParser.CountPresence(query, "--not-present");
+            }
+        });
+        auto mBitset = Measure(nIterations, [&]() {
+            ArgParser argParser(synth.argv.size(), synth.argv.data());
+            for(auto query : kQueries) {
+                sink = sink + argParser.IsPresent(query) + argParser.CountPresence(query);
+            }
+        });
+        PrintMeasurement("scan", nTokens, mScan);
+        PrintMeasurement("bitset", nTokens, mBitset);
+    }
+    printf("\n");
+}
+
+// Startup path of a small tool - construct a parser and query a handful of options, ArgParser versus the heap
+// free StaticArgParser
+static void BenchStatic() {
+    static const size_t nCommands = 1000;
+    std::vector<SyntheticArgs> commands;
+    for(size_t i=0;i<nCommands;i++) {
+        SyntheticArgs synth;
+        synth.strings = {"tool", "-vx", "--threads", std::to_string(1 + i % 16), "--root", "/srv/data/" + std::to_string(i),
+                         "--ids=1,2,3,4", "--", "file1", "file2"};
+        synth.Finalize();
+        commands.push_back(std::move(synth));
+    }
+
+    volatile size_t sink = 0;
+    auto cbQueries = [&sink](auto &argParser) {
+        argParser.SetStopCondition("--");
+        sink = sink + argParser.IsPresent("-v", "--verbose");
+        sink = sink + *argParser.TryParse(1, "-t", "--threads");
+        sink = sink + argParser.TryParse(std::string_view("/"), "-r", "--root")->size();
+    };
+
+    auto mDynamic = Measure(100, [&]() {
+        for(auto &command : commands) {
+            ArgParser argParser(command.argv.size(), command.argv.data());
+            cbQueries(argParser);
+            std::vector<int> ids;
+            sink = sink + argParser.TryParseList(ids, "-i", "--ids");
+            std::vector<std::string_view> unconsumed;
+            sink = sink + argParser.Unconsumed(unconsumed);
+        }
+    });
+    // same queries, the results go to fixed size storage
+    auto mStatic = Measure(100, [&]() {
+        for(auto &command : commands) {
+            StaticArgParser<16, 32> argParser(command.argv.size(), command.argv.data());
+            cbQueries(argParser);
+            std::array<int, 8> ids;
+            sink = sink + argParser.TryParseList(std::span(ids), "-i", "--ids");
+            std::array<std::string_view, 8> unconsumed;
+            sink = sink + argParser.Unconsumed(std::span(unconsumed));
+        }
+    });
+
+    printf("StaticArgParser - %zu commands, construct and query\n", nCommands);
+    printf("  ArgParser:       %8.1f ns/command %6.2f allocs/command\n", mDynamic.ns / nCommands, mDynamic.nAllocations / nCommands);
+    printf("  StaticArgParser: %8.1f ns/command %6.2f allocs/command\n", mStatic.ns / nCommands, mStatic.nAllocations / nCommands);
+    printf("\n");
+}
+
+// Container style startup - 150 options each with an environment variable fallback, TryParse followed by getenv
+// versus the ArgEnv fallback resolved through the environ index. The variables are set after a growing number of
+// unrelated ones, getenv scans all of those for every option.
+static void BenchEnvironment() {
+    static const size_t nOptions = 150;
+    std::vector<std::string> longNames, envNames;
+    for(size_t i=0;i<nOptions;i++) {
+        longNames.push_back("--option-" + std::to_string(i));
+        envNames.push_back("APP_OPTION_" + std::to_string(i));
+    }
+    const char *argv[] = {"prgname", "--option-0", "1", nullptr};
+
+    printf("Environment fallback - %zu options\n", nOptions);
+    size_t nFiller = 0;
+    for(size_t nEnv : {100, 1000, 10000}) {
+        for(;nFiller < nEnv;nFiller++) {
+            setenv(("FILLER_" + std::to_string(nFiller)).c_str(), "some value", 1);
+        }
+        // re-set so they come after the filler
+        for(size_t i=0;i<nOptions;i++) {
+            unsetenv(envNames[i].c_str());
+            setenv(envNames[i].c_str(), std::to_string(i).c_str(), 1);
+        }
+
+        volatile size_t sink = 0;
+        auto mGetenv = Measure(20, [&]() {
+            ArgParser argParser(3, argv);
+            for(size_t i=0;i<nOptions;i++) {
+                int defaultValue = 0;
+                if (auto env = getenv(envNames[i].c_str())) {
+                    defaultValue = atoi(env);
+                }
+                sink = sink + *argParser.TryParse(defaultValue, "", longNames[i]);
+            }
+        });
+        auto mIndex = Measure(20, [&]() {
+            ArgParser argParser(3, argv);
+            for(size_t i=0;i<nOptions;i++) {
+                sink = sink + *argParser.TryParse(0, "", longNames[i], ArgEnv(envNames[i]));
+            }
+        });
+        printf("  %5zu variables - getenv: %10.1f ns/parser   ArgEnv: %10.1f ns/parser %6.2f allocs/parser\n",
+               nEnv + nOptions, mGetenv.ns, mIndex.ns, mIndex.nAllocations);
+    }
+    for(size_t i=0;i<nFiller;i++) {
+        unsetenv(("FILLER_" + std::to_string(i)).c_str());
+    }
+    for(auto &name : envNames) {
+        unsetenv(name.c_str());
+    }
+    printf("\n");
+}
+
+// Generated config file - map + parse + index throughput against the 1 ms/MB budget, then option lookups through
+// the parser resolved from the file
+static void BenchConfigFile(size_t nMegaBytes) {
+    char filename[] = "/tmp/argparser_benchXXXXXX";
+    int fd = mkstemp(filename);
+    if (fd < 0) {
+        printf("Config file - unable to create temporary file\n\n");
+        return;
+    }
+
+    // sections of key/value lines with the odd comment and quoted value
+    size_t szTarget = nMegaBytes * 1024 * 1024;
+    size_t szWritten = 0;
+    std::string chunk;
+    for(size_t i=0;szWritten < szTarget;) {
+        chunk.clear();
+        chunk += "\n[service" + std::to_string(i) + "]\n# generated\n";
+        for(size_t j=0;j<256;j++,i++) {
+            if ((i % 32) == 0) {
+                chunk += "description_" + std::to_string(j) + " = \"some text with spaces " + std::to_string(i) + "\"\n";
+            } else {
+                chunk += "option_" + std::to_string(j) + " = " + std::to_string(i * 7) + "\n";
+            }
+        }
+        if (write(fd, chunk.data(), chunk.size()) != (ssize_t)chunk.size()) {
+            break;
+        }
+        szWritten += chunk.size();
+    }
+    close(fd);
+
+    size_t nKeys = 0;
+    auto nsOpen = MeasureNs(3, [&]() {
+        ArgConfigFile configFile;
+        configFile.Open(filename);
+        nKeys = configFile.Count();
+    });
+
+    static const size_t nLookups = 1000;
+    std::vector<std::string> longNames;
+    for(size_t i=0;i<nLookups;i++) {
+        longNames.push_back("--service0.option_" + std::to_string(1 + i % 255));
+    }
+    const char *argv[] = { "prgname.exe", "-v", nullptr };
+    ArgParser argParser(2, argv);
+    argParser.LoadConfig(filename);
+    unlink(filename);
+    volatile size_t sink = 0;
+    auto mLookup = Measure(100, [&]() {
+        for(auto &name : longNames) {
+            sink = sink + *argParser.TryParse<size_t>(0, "", name);
+        }
+    });
+
+    auto mb = static_cast<double>(szWritten) / (1024.0 * 1024.0);
+    printf("Config file - %.1f MB, %zu keys\n", mb, nKeys);
+    printf("  map + parse + index: %8.2f ms/MB %8.1f MB/s\n", (nsOpen * 1e-6) / mb, mb / (nsOpen * 1e-9));
+    printf("  TryParse from file:  %8.1f ns/lookup %6.2f allocs/lookup\n", mLookup.ns / nLookups, mLookup.nAllocations / nLookups);
+    printf("\n");
+}
+
+// Tokenizing single string commands, like from a REPL
+static void BenchCommandLine() {
+    static const size_t nCommands = 1000000;
+    std::vector<std::string> commands;
+    size_t nBytes = 0;
+    for(size_t i=0;i<1000;i++) {
+        auto &cmd = commands.emplace_back("set --key config.key." + std::to_string(i) + " --value 'some value " + std::to_string(i) + "' -v file\\ name");
+        nBytes += cmd.size();
+    }
+
+    ArgCommandLine cmdLine;
+    volatile size_t sink = 0;
+    auto m = Measure(1, [&]() {
+        for(size_t i=0;i<nCommands;i++) {
+            sink = sink + cmdLine.Tokenize(commands[i % commands.size()]);
+        }
+    });
+    auto mb = static_cast<double>(nBytes) * (nCommands / commands.size()) / (1024.0 * 1024.0);
+    printf("Command line tokenizer - %zu commands\n", nCommands);
+    printf("  Tokenize:        %8.1f ns/command %8.1f MB/s %6.2f allocs/command\n", m.ns / nCommands, mb / (m.ns * 1e-9), m.nAllocations / nCommands);
+    printf("\n");
+}
+
+// Git style tool with 60 subcommands - picking the command with a chain of string compares and building a parser on
+// the rest of argv, versus the compile time trie and a parser over the slice of argv
+using BenchCommands = ArgSubcommands<"add", "am", "annotate", "apply", "archive", "bisect", "blame", "branch",
+                                     "bundle", "checkout", "cherry", "cherry-pick", "citool", "clean", "clone",
+                                     "commit", "config", "count-objects", "describe", "diff", "difftool", "fetch",
+                                     "format-patch", "fsck", "gc", "grep", "gui", "help", "init", "instaweb", "log",
+                                     "maintenance", "merge", "mergetool", "mv", "notes", "prune", "pull", "push",
+                                     "range-diff", "rebase", "reflog", "remote", "repack", "replace", "request-pull",
+                                     "reset", "restore", "revert", "rm", "shortlog", "show", "show-branch",
+                                     "sparse-checkout", "stash", "status", "submodule", "switch", "tag", "worktree">;
+static const char *kBenchCommandNames[] = {"add", "am", "annotate", "apply", "archive", "bisect", "blame", "branch",
+    "bundle", "checkout", "cherry", "cherry-pick", "citool", "clean", "clone", "commit", "config", "count-objects",
+    "describe", "diff", "difftool", "fetch", "format-patch", "fsck", "gc", "grep", "gui", "help", "init", "instaweb",
+    "log", "maintenance", "merge", "mergetool", "mv", "notes", "prune", "pull", "push", "range-diff", "rebase",
+    "reflog", "remote", "repack", "replace", "request-pull", "reset", "restore", "revert", "rm", "shortlog", "show",
+    "show-branch", "sparse-checkout", "stash", "status", "submodule", "switch", "tag", "worktree"};
+
+static void BenchSubcommands() {
+    static const size_t nCommands = 1000;
+    static const size_t nNames = std::size(kBenchCommandNames);
+    std::vector<SyntheticArgs> commands;
+    for(size_t i=0;i<nCommands;i++) {
+        SyntheticArgs synth;
+        synth.strings = {"tool", "-C", "path/to/repo", "-v", kBenchCommandNames[(i * 7) % nNames], "-m", std::to_string(i), "--", "file"};
+        synth.Finalize();
+        commands.push_back(std::move(synth));
+    }
+
+    volatile size_t sink = 0;
+    auto cbHandler = [&sink](ArgParser &args) {
+        sink = sink + args.TryParse(std::string_view{}, "-m", "--message")->size();
+        return 0;
+    };
+
+    auto mCompare = Measure(100, [&]() {
+        for(auto &command : commands) {
+            ArgParser argParser(command.argv.size(), command.argv.data());
+            argParser.SetStopCondition("--");
+            sink = sink + argParser.TryParse(std::string_view("."), "-C")->size();
+            for(size_t idx=1;idx<command.argv.size();idx++) {
+                if (command.argv[idx][0] == '-') continue;
+                if (command.argv[idx - 1] == std::string_view("-C")) continue;
+                size_t idxName = 0;
+                while((idxName < nNames) && (std::strcmp(command.argv[idx], kBenchCommandNames[idxName]) != 0)) {
+                    idxName++;
+                }
+                ArgParser subParser(command.argv.size() - idx, command.argv.data() + idx);
+                subParser.SetStopCondition("--");
+                sink = sink + idxName + cbHandler(subParser);
+                break;
+            }
+        }
+    });
+    auto mDispatch = Measure(100, [&]() {
+        for(auto &command : commands) {
+            ArgParser argParser(command.argv.size(), command.argv.data());
+            argParser.SetStopCondition("--");
+            sink = sink + argParser.TryParse(std::string_view("."), "-C")->size();
+            sink = sink + [&]<size_t... I>(std::index_sequence<I...>) {
+                return *BenchCommands::Dispatch(argParser, ((void)I, cbHandler)...);
+            }(std::make_index_sequence<BenchCommands::nCommands>{});
+        }
+    });
+
+    // the lookup alone
+    static const size_t nLookups = 1000000;
+    auto mStrcmp = Measure(1, [&]() {
+        for(size_t i=0;i<nLookups;i++) {
+            auto name = kBenchCommandNames[(i * 7) % nNames];
+            size_t idxName = 0;
+            while((idxName < nNames) && (std::strcmp(name, kBenchCommandNames[idxName]) != 0)) {
+                idxName++;
+            }
+            sink = sink + idxName;
+        }
+    });
+    auto mTrie = Measure(1, [&]() {
+        for(size_t i=0;i<nLookups;i++) {
+            sink = sink + BenchCommands::Lookup(kBenchCommandNames[(i * 7) % nNames]);
+        }
+    });
+
+    printf("Subcommands - %zu commands\n", nNames);
+    printf("  strcmp chain lookup:    %8.1f ns/lookup\n", mStrcmp.ns / nLookups);
+    printf("  trie lookup:            %8.1f ns/lookup\n", mTrie.ns / nLookups);
+    printf("  strcmp + new parser:    %8.1f ns/command %6.2f allocs/command\n", mCompare.ns / nCommands, mCompare.nAllocations / nCommands);
+    printf("  Dispatch:               %8.1f ns/command %6.2f allocs/command\n", mDispatch.ns / nCommands, mDispatch.nAllocations / nCommands);
+    printf("\n");
+}
+
+// Shell completion with 10k generated long options, like per metric toggles. Each keypress runs the tool once, so
+// registering the names and building the index count as much as answering the query.
+static void BenchCompletion() {
+    static const size_t nOptions = 10000;
+    std::vector<std::string> names;
+    for(size_t i=0;i<nOptions;i++) {
+        names.push_back("--metric-" + std::to_string(i) + ((i & 1) ? "-enable" : "-interval"));
+    }
+    std::vector<std::string> shuffled = names;
+    std::sort(shuffled.begin(), shuffled.end());
+    std::vector<std::string> ordered = shuffled;
+    // deterministic shuffle
+    for(size_t i=shuffled.size() - 1;i>0;i--) {
+        std::swap(shuffled[i], shuffled[(i * 7919) % (i + 1)]);
+    }
+
+    const char *wordsNarrow[] = {"tool", "-v", "--metric-4711", "5", "--metric-123"};
+    const char *wordsWide[] = {"tool", "--metric-1"};
+    volatile size_t sink = 0;
+    std::vector<std::string_view> candidates;
+    candidates.reserve(nOptions);
+
+    auto cbRegister = [](ArgCompletion &completion, const std::vector<std::string> &optionNames) {
+        completion.Flag("-v", "--verbose");
+        for(size_t i=0;i<optionNames.size();i++) {
+            if (optionNames[i].ends_with("-interval")) {
+                completion.Value("", optionNames[i]);
+            } else {
+                completion.Flag("", optionNames[i]);
+            }
+        }
+    };
+
+    printf("Completion - %zu options\n", nOptions);
+    for(auto *optionNames : {&ordered, &shuffled}) {
+        auto mStartup = Measure(20, [&]() {
+            ArgCompletion completion;
+            cbRegister(completion, *optionNames);
+            candidates.clear();
+            sink = sink + completion.Complete(wordsNarrow, candidates);
+        });
+        printf("  register + index + complete (%s): %8.1f us %8.2f allocs\n", (optionNames == &ordered) ? "sorted" : "shuffled",
+               mStartup.ns * 1e-3, mStartup.nAllocations);
+    }
+
+    ArgCompletion completion;
+    cbRegister(completion, shuffled);
+    candidates.clear();
+    completion.Complete(wordsNarrow, candidates);
+    static const size_t nQueries = 10000;
+    for(auto words : {std::span<const char *const>(wordsNarrow), std::span<const char *const>(wordsWide)}) {
+        size_t nCandidates = 0;
+        auto mIndex = Measure(nQueries, [&]() {
+            candidates.clear();
+            nCandidates = completion.Complete(words, candidates);
+        });
+        // linear scan over all names as baseline
+        std::string_view prefix = words.back();
+        auto mScan = Measure(nQueries, [&]() {
+            candidates.clear();
+            for(auto &name : shuffled) {
+                if (std::string_view(name).starts_with(prefix)) {
+                    candidates.push_back(name);
+                }
+            }
+        });
+        sink = sink + nCandidates;
+        printf("  complete '%s' (%zu candidates) - index: %8.2f us   scan: %8.2f us\n", words.back(), nCandidates, mIndex.ns * 1e-3, mScan.ns * 1e-3);
+    }
+    printf("\n");
+}
+
+// 'Did you mean' for a mistyped option against 10k registered names - the bounded bit-parallel kernel versus the
+// plain dynamic program over every name
+static void BenchSuggest() {
+    static const size_t nOptions = 10000;
+    ArgCompletion completion;
+    std::vector<std::string> names;
+    for(size_t i=0;i<nOptions;i++) {
+        names.push_back("--metric-" + std::to_string(i) + ((i & 1) ? "-enable" : "-interval"));
+        completion.Flag("", names.back());
+    }
+
+    auto cbClassic = [](std::string_view a, std::string_view b) {
+        std::vector<size_t> prev(b.length() + 1), cur(b.length() + 1);
+        for(size_t j=0;j<prev.size();j++) {
+            prev[j] = j;
+        }
+        for(size_t i=0;i<a.length();i++) {
+            cur[0] = i + 1;
+            for(size_t j=0;j<b.length();j++) {
+                cur[j + 1] = std::min({prev[j] + ((a[i] == b[j]) ? 0 : 1), prev[j + 1] + 1, cur[j] + 1});
+            }
+            std::swap(prev, cur);
+        }
+        return prev.back();
+    };
+
+    printf("Suggest - %zu names\n", nOptions);
+    volatile size_t sink = 0;
+    std::vector<std::string_view> suggestions;
+    for(std::string_view typo : {"--metric-4711-enabel", "--metirc-12-interval", "--no-such-option"}) {
+        size_t nFound = 0;
+        auto mSuggest = Measure(20, [&]() {
+            suggestions.clear();
+            nFound = completion.Suggest(typo, suggestions);
+        });
+        auto mKernel = Measure(20, [&]() {
+            ArgEditDistance editDistance(typo);
+            for(auto &name : names) {
+                sink = sink + editDistance.Distance(name, 2);
+            }
+        });
+        auto mClassic = Measure(5, [&]() {
+            for(auto &name : names) {
+                sink = sink + cbClassic(typo, name);
+            }
+        });
+        printf("  '%.*s' (%zu found) - Suggest: %8.1f us   kernel only: %8.1f us   dynamic program: %8.1f us\n",
+               (int)typo.size(), typo.data(), nFound, mSuggest.ns * 1e-3, mKernel.ns * 1e-3, mClassic.ns * 1e-3);
+    }
+    printf("\n");
+}
+
+int main(int argc, const char **argv) {
+    ArgParser argParser(argc, argv);
+    auto responseFileMB = *argParser.TryParse<size_t>(64, "-r", "--response-mb");
+    auto maxTokens = *argParser.TryParse<size_t>(1000000, "-m", "--max-tokens");
+
+    BenchShapes(maxTokens);
+
+    BenchIndexScaling();
+    BenchResponseFile(responseFileMB);
+    BenchList();
+    BenchReset();
+    BenchShortFlags();
+    BenchAccumulate();
+    BenchAttached();
+    BenchEndArgsParallel();
+    BenchNumbers();
+    BenchConverters();
+    BenchDiagnostics();
+    BenchStatic();
+    BenchEnvironment();
+    BenchConfigFile(10);
+    BenchCommandLine();
+    BenchSubcommands();
+    BenchCompletion();
+    BenchSuggest();
+    return 0;
+}
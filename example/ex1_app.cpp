@@ -18,6 +18,23 @@ static void ParseConfig(int argc, const char **argv) {
     glb_Config.outputFile = *argParser.TryParse(glb_Config.outputFile, "-o", "--output");
 }
 
+// same as above but binding the struct members, all fields are filled in a single pass over the arguments
+static bool BindConfig(int argc, const char **argv) {
+    ArgParser argParser(argc, argv);
+    ArgBinder<AppConfig> binder(argParser);
+    binder.Count(&AppConfig::verboseLevel, "-v")
+          .Value(&AppConfig::someInteger, "-n", "--number")
+          .Value(&AppConfig::inputFile, "-i", "--input")
+          .Value(&AppConfig::outputFile, "-o", "--output");
+
+    auto res = binder.Bind(glb_Config);
+    if (!res.IsOk()) {
+        printf("Invalid value for '%.*s'\n", (int)res.option.size(), res.option.data());
+        return false;
+    }
+    return true;
+}
+
 static bool ParseConfigErrorHandling(int argc, const char **argv) {
     ArgParser argParser(argc, argv);
     glb_Config.verboseLevel = argParser.CountPresence("-v");
@@ -46,6 +63,15 @@ int main(int argc, const char **argv) {
         printf(" -n/--number    define some integer\n");
         printf(" -i/--input     define the input filename\n");
         printf(" -o/--output    define the output filename\n");
+        printf(" --bind         fill the config with ArgBinder and print it\n");
+        return 0;
+    }
+    if (argParser.IsPresent("--bind")) {
+        if (!BindConfig(argc, argv)) {
+            return 1;
+        }
+        printf("verbose=%d number=%d input=%s output=%s\n", glb_Config.verboseLevel, glb_Config.someInteger,
+               glb_Config.inputFile.c_str(), glb_Config.outputFile.c_str());
         return 0;
     }
     printf("Try starting with '-h' or '--help'\n");
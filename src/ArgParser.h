@@ -12,8 +12,49 @@
 #include <ranges>
 #include <algorithm>
 #include <charconv>
-#include <unordered_map>
+#include <optional>
 #include <vector>
+#include <unordered_map>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cfloat>
+#include <limits>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <type_traits>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <memory>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GNILK_ARGPARSER_HAVE_MMAP
+#endif
+
+#if defined(_WIN32)
+#include <stdlib.h>
+#define GNILK_ARGPARSER_ENVIRON _environ
+#else
+extern "C" char **environ;
+#define GNILK_ARGPARSER_ENVIRON environ
+#endif
 
 //
 // simple decent modern argument parser
@@ -24,7 +65,20 @@
 //  - Flags present/non-present (on/off toggles)
 //  - Count the presence of an option across all arguments (like; verbose level)
 //  - Arguments carrying single value
+//  - Attached values ('--name=value', '-nVALUE')
 //  - Catch all at the end
+//  - Optional argv index (BuildIndex) - tokenize argv once, queries become O(1) lookups
+//  - Response files ('@file') - memory mapped and tokenized in place
+//  - Delimited lists in a single argument (like; '--ids 1,2,3')
+//  - Repeated options collected in one pass (like; '-I dir1 -I dir2' or '-D KEY=VALUE')
+//  - Unknown option detection, arguments not used by any query (Unconsumed)
+//  - User types through ArgConverter<T> or ArgFromString, built in sizes ('4K'), durations ('1h30m') and enums
+//  - Environment variable fallback for options (ArgEnv), resolved through a one-time index of the environment
+//  - Config files (LoadConfig) as the lowest layer, file < environment < command line, memory mapped and hashed once
+//  - Heap free StaticArgParser<MaxOptions, MaxArgs> for startup critical code
+//  - Git style subcommands (ArgSubcommands) dispatched through a compile time trie, each on its slice of argv
+//  - Shell completion (ArgCompletion, '--__complete') over a sorted index of the option names
+//  - 'Did you mean' suggestions for unknown options (ArgCompletion::Suggest), bounded bit-parallel edit distance
 //
 // Unsupported features:
 //  - advanced 'catch end'
@@ -41,360 +95,5229 @@
 // Fix:
 //   Need ability to set a stop condition (like; don't go beyond '--')
 //
-class ArgParser {
+
+//
+// Shell like tokenizer, in place or into a separate buffer
+//  - whitespace separates arguments
+//  - '...' is taken literally
+//  - "..." allows escaping of '"' and '\' with a backslash
+//  - outside quotes a backslash escapes any character
+// Quotes and escapes are removed while writing the arguments out and each argument is zero terminated where it ends.
+// The output never grows beyond the input plus one byte, in place the buffer must have one writable byte past 'end'.
+//
+class ArgTokenizer {
 protected:
-    enum class kParseResult {
-        Ok,
-        OkNotPresent,
-        ErrMissingArg,
-        ErrArgTypeError,
+    enum kCharClass : uint8_t {
+        kPlain,
+        kSpace,
+        kEscape,
+        kSingleQuote,
+        kDoubleQuote,
     };
-public:
-    ArgParser() = delete;
-    ArgParser(size_t argc, const char **argv) : args{argv, argc} {
+    static constexpr std::array<uint8_t, 256> charClass = [] {
+        std::array<uint8_t, 256> table = {};
+        table[' '] = table['\t'] = table['\n'] = table['\r'] = table['\v'] = table['\f'] = kSpace;
+        table['\\'] = kEscape;
+        table['\''] = kSingleQuote;
+        table['"'] = kDoubleQuote;
+        return table;
+    }();
+    // True if any of the 8 characters is whitespace, a quote or a backslash - or might be, any byte below 0x21 (all
+    // whitespace) or with the high bit set (utf-8) goes through the table
+    static bool HasSpecial(uint64_t x) {
+        static constexpr uint64_t ones = 0x0101010101010101ull;
+        static constexpr uint64_t highs = 0x8080808080808080ull;
+        auto hasByte = [](uint64_t x, uint8_t ch) {
+            auto v = x ^ (ones * ch);
+            return (v - ones) & ~v & highs;
+        };
+        auto special = ((x - ones * 0x21) | x) & highs;
+        special |= hasByte(x, '\\') | hasByte(x, '\'') | hasByte(x, '"');
+        return special != 0;
     }
-    virtual ~ArgParser() = default;
 
-    void SetStopCondition(const std::string &stopArg) {
-        stoparg = stopArg;
+    // Copy plain characters, 8 at a time while none of them is special. Returns the first character not copied,
+    // 'dst' is advanced - in place it is never ahead of 'src' so a word is always read before it is overwritten.
+    static const char *CopyPlain(const char *src, const char *end, char *&dst) {
+        while((end - src) >= 8) {
+            uint64_t x;
+            memcpy(&x, src, sizeof(x));
+            if (HasSpecial(x)) break;
+            memcpy(dst, &x, sizeof(x));
+            src += 8;
+            dst += 8;
+        }
+        while((src != end) && (charClass[static_cast<uint8_t>(*src)] == kPlain)) *dst++ = *src++;
+        return src;
+    }
+public:
+    static void TokenizeInPlace(char *begin, char *end, std::vector<const char *> &outArgs) {
+        Tokenize(begin, end, begin, outArgs);
     }
 
-    // Parse flags (true/false) based on presence of an option...  expecting no arguments...
-    [[nodiscard]]
-    bool IsPresent(const std::string &shortParamName, const std::string &longParamName = {}) {
-        auto cbValue = [](int idxParam) { return kParseResult::Ok; };
-        auto res = TryParseInternal(false, cbValue, shortParamName, longParamName);
-        if (res != kParseResult::Ok) {
-            return false;
+    // Reads 'src' to 'end' and writes the arguments to 'dst' which has room for 'end - src + 1' bytes. 'dst' may
+    // be 'src' (in place) but must not point into the text after it.
+    static void Tokenize(const char *src, const char *end, char *dst, std::vector<const char *> &outArgs) {
+        while(src != end) {
+            // skip whitespace between arguments
+            while((src != end) && (charClass[static_cast<uint8_t>(*src)] == kSpace)) ++src;
+            if (src == end) break;
+
+            const char *argStart = dst;
+            while(src != end) {
+                auto cls = charClass[static_cast<uint8_t>(*src)];
+                if (cls == kPlain) {
+                    // fast path - nothing to unescape
+                    src = CopyPlain(src, end, dst);
+                    continue;
+                }
+                if (cls == kSpace) break;
+                if (cls == kEscape) {
+                    ++src;
+                    if (src != end) *dst++ = *src++;
+                } else if (cls == kSingleQuote) {
+                    ++src;
+                    while((src != end) && (*src != '\'')) *dst++ = *src++;
+                    if (src != end) ++src;
+                } else {
+                    ++src;
+                    while((src != end) && (*src != '"')) {
+                        if ((*src == '\\') && ((src + 1) != end) && ((src[1] == '"') || (src[1] == '\\'))) ++src;
+                        *dst++ = *src++;
+                    }
+                    if (src != end) ++src;
+                }
+            }
+            // src is either at the end or at whitespace, in place dst <= src so this never overwrites unread text
+            // except for the very last argument where dst == end is the extra byte
+            if (src != end) ++src;
+            *dst++ = '\0';
+            outArgs.push_back(argStart);
         }
-        update_paramargs(shortParamName, longParamName, 0);
-        return true;
     }
+};
 
-    // Parse an argument with a single expected value - without default (can be treated as 'must have')
-    // Must be called explicitly like: 'TryParse<int>(...)' as C++ can't/won't deduce type-specification based on the return
-    template<typename TValue>
-    [[nodiscard]]
-    std::optional<TValue> TryParse(const std::string &shortParamName, const std::string &longParamName = {}) {
-        return TryParse<TValue>({}, shortParamName, longParamName);
+//
+// Command line given as a single string (like from a REPL or a control socket) turned into argc/argv.
+// The arguments point into one internal buffer which is reused, tokenizing is linear and once warmed up
+// there are no allocations.
+//
+// Use like:
+//      ArgCommandLine cmdLine;
+//      cmdLine.Tokenize("set --key 'some value' -v");
+//      ArgParser argParser(cmdLine.Argc(), cmdLine.Argv());
+//
+class ArgCommandLine {
+public:
+    ArgCommandLine() = default;
+    virtual ~ArgCommandLine() = default;
+    // argv points into our own buffer
+    ArgCommandLine(const ArgCommandLine &) = delete;
+    ArgCommandLine &operator=(const ArgCommandLine &) = delete;
+
+    // Tokenize a new command line, previous arguments are invalidated
+    size_t Tokenize(std::string_view cmdLine) {
+        buffer.assign(cmdLine.begin(), cmdLine.end());
+        // the tokenizer needs one byte past the end
+        buffer.push_back('\0');
+        argv.clear();
+        ArgTokenizer::TokenizeInPlace(buffer.data(), buffer.data() + cmdLine.size(), argv);
+        return argv.size();
     }
 
-    // Same as above but for r-value ref's
-    template<typename TValue>
     [[nodiscard]]
-    std::optional<TValue> TryParse(const TValue &&defaultValue, const std::string &shortParamName, const std::string &longParamName = {}) {
-        return TryParse(defaultValue, shortParamName, longParamName);
+    size_t Argc() const {
+        return argv.size();
     }
-
-    // Parse an argument with a single expected value - using a default value if arument is not present...
-    // type deduction based on the default value...
-    template<typename TValue>
     [[nodiscard]]
-    std::optional<TValue> TryParse(const TValue &defaultValue, const std::string &shortParamName, const std::string &longParamName = {}) {
-        // pre-populate with default value, will be set to parsed/converted value by Lamda if everything works out...
-        TValue result = {defaultValue};
-        auto valueFunc = [&result, this](int idxArgValue) -> kParseResult {
-                const std::string_view argValue = args[idxArgValue];
-                auto res = convert_to<TValue>(argValue);
-                if (!res.has_value()) {
-                    return kParseResult::ErrArgTypeError;
-                }
-                result = *res;
-                return kParseResult::Ok;
-        };
+    const char **Argv() {
+        return argv.data();
+    }
+private:
+    std::vector<char> buffer;
+    std::vector<const char *> argv;
+};
 
-        auto res = TryParseInternal(true, valueFunc, shortParamName, longParamName);
-        if (res == kParseResult::Ok) {
-            update_paramargs(shortParamName, longParamName, 1);
+//
+// A file mapped in memory, followed by at least one zero byte. Mapped read-only the pages stay shared with the page
+// cache, mapped copy-on-write it is writable - for parsers working in place, every page written is copied.
+// Without mmap the file is read into a buffer instead.
+//
+class ArgMappedFile {
+public:
+    enum class kAccess {
+        ReadOnly,
+        CopyOnWrite,
+    };
+
+    ArgMappedFile() = default;
+    virtual ~ArgMappedFile() {
+        Close();
+    }
+    ArgMappedFile(const ArgMappedFile &) = delete;
+    ArgMappedFile &operator=(const ArgMappedFile &) = delete;
+
+    // Returns false if the file can't be read
+    bool Open(const char *filename, kAccess access = kAccess::CopyOnWrite) {
+        Close();
+#ifdef GNILK_ARGPARSER_HAVE_MMAP
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            return false;
         }
-        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
-            return result;
+        struct stat st = {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        auto szData = static_cast<size_t>(st.st_size);
+        auto szPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        // Reserve one page more than needed, it stays anonymous zero-filled memory which gives us the
+        // byte past the end for the last terminator (a file mapping would SIGBUS beyond the last page)
+        szMapped = ((szData + szPage) / szPage) * szPage;
+        int prot = (access == kAccess::ReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void *base = mmap(nullptr, szMapped, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        int flags = MAP_PRIVATE | MAP_FIXED;
+        if (access == kAccess::ReadOnly) {
+            flags = MAP_SHARED | MAP_FIXED;
+#ifdef MAP_POPULATE
+            // fault in everything up front instead of page by page while parsing - only a read-only mapping,
+            // populating a writable private one would copy every page
+            flags |= MAP_POPULATE;
+#endif
+        }
+        if ((szData > 0) && (mmap(base, szData, prot, flags, fd, 0) == MAP_FAILED)) {
+            munmap(base, szMapped);
+            close(fd);
+            return false;
+        }
+        close(fd);
+        data = static_cast<char *>(base);
+        szFile = szData;
+#else
+        FILE *f = fopen(filename, "rb");
+        if (f == nullptr) {
+            return false;
         }
+        int ch;
+        while((ch = fgetc(f)) != EOF) {
+            buffer.push_back(static_cast<char>(ch));
+        }
+        fclose(f);
+        szFile = buffer.size();
+        buffer.push_back('\0');
+        data = buffer.data();
+#endif
+        return true;
+    }
 
-        return {};
+    void Close() {
+#ifdef GNILK_ARGPARSER_HAVE_MMAP
+        if (data != nullptr) {
+            munmap(data, szMapped);
+            szMapped = 0;
+        }
+#else
+        buffer.clear();
+#endif
+        data = nullptr;
+        szFile = 0;
     }
 
-    // Parse an argument with an array as expected value
-    template<typename TValue>
+    // The file contents, Data()[Size()] is zero - only writable when opened copy-on-write
+    [[nodiscard]]
+    char *Data() {
+        return data;
+    }
     [[nodiscard]]
-    int TryParse(std::vector<TValue> &outValues, const std::string &shortParamName, const std::string &longParamName = {}) {
-        int nCopied = 0;
+    const char *Data() const {
+        return data;
+    }
+    [[nodiscard]]
+    size_t Size() const {
+        return szFile;
+    }
+private:
+    char *data = nullptr;
+    size_t szFile = 0;
+#ifdef GNILK_ARGPARSER_HAVE_MMAP
+    size_t szMapped = 0;
+#else
+    std::vector<char> buffer;
+#endif
+};
 
-        // lambda to convert an array of TValue
-        // like: '--input_files <f1> <f2> <f3> <f4>
-        auto valueFunc = [&outValues, &nCopied, this](int idxArgValue) -> kParseResult {
+//
+// Splits a delimited list ('1,2,3') - the separator scan is done 32 (AVX2) or 16 (SSE2) bytes at a time
+// with a scalar fallback for other targets.
+//
+class ArgListSplitter {
+public:
+    // Number of elements in the list, an empty string has no elements
+    [[nodiscard]]
+    static size_t Count(std::string_view list, char separator) {
+        if (list.empty()) {
+            return 0;
+        }
+        size_t nElements = 1;
+        ForEachSeparator(list, separator, [&nElements](size_t) { nElements++; });
+        return nElements;
+    }
 
-            while(true) {
-                // FIXME: Split this string in ',' as an optional...
-                auto v = convert_to<TValue>(args[idxArgValue]);
-                if (!v.has_value()) {
-                    return kParseResult::ErrArgTypeError;
-                }
-                outValues.push_back(*v);
-                if ((idxArgValue + 1) >= args.size()) break;
-                if (args[idxArgValue+1][0] == '-') break;
-                ++idxArgValue;
-                ++nCopied;
+    // Calls 'cbElement' with each element, stops and returns false if the callback returns false
+    template<typename TFunc>
+    static bool Split(std::string_view list, char separator, TFunc cbElement) {
+        if (list.empty()) {
+            return true;
+        }
+        size_t idxStart = 0;
+        bool bOk = true;
+        ForEachSeparator(list, separator, [&](size_t idxSeparator) {
+            if (bOk) {
+                bOk = cbElement(list.substr(idxStart, idxSeparator - idxStart));
             }
-            return kParseResult::Ok;
-        };
+            idxStart = idxSeparator + 1;
+        });
+        return bOk && cbElement(list.substr(idxStart));
+    }
 
-        auto res = TryParseInternal(true, valueFunc, shortParamName, longParamName);
-        if (res == kParseResult::Ok) {
-            update_paramargs(shortParamName, longParamName, nCopied);
+protected:
+    template<typename TFunc>
+    static void ForEachSeparator(std::string_view list, char separator, TFunc cbSeparator) {
+        size_t idx = 0;
+#if defined(__AVX2__)
+        auto vSeparator = _mm256_set1_epi8(separator);
+        for(;idx + 32 <= list.size(); idx += 32) {
+            auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(list.data() + idx));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, vSeparator)));
+            while(mask != 0) {
+                cbSeparator(idx + static_cast<size_t>(std::countr_zero(mask)));
+                mask &= mask - 1;
+            }
         }
-        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
-            return nCopied;
+#endif
+#if defined(__SSE2__)
+        auto vSeparator16 = _mm_set1_epi8(separator);
+        for(;idx + 16 <= list.size(); idx += 16) {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(list.data() + idx));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vSeparator16)));
+            while(mask != 0) {
+                cbSeparator(idx + static_cast<size_t>(std::countr_zero(mask)));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for(;idx < list.size(); idx++) {
+            if (list[idx] == separator) {
+                cbSeparator(idx);
+            }
         }
+    }
+};
 
-        return 0;
+//
+// Response file, the file is mapped read-only and tokenized in one pass into a buffer of its own - the mapping is
+// never written (so never copied page by page) and is unmapped again once tokenized. Arguments point into the buffer
+// and are zero terminated, ready for an argv.
+//
+class ArgResponseFile {
+public:
+    ArgResponseFile() = default;
+    virtual ~ArgResponseFile() = default;
+    ArgResponseFile(const ArgResponseFile &) = delete;
+    ArgResponseFile &operator=(const ArgResponseFile &) = delete;
+
+    // Map and tokenize the file, returns false if the file can't be read
+    bool Open(const char *filename) {
+        tokens.clear();
+        text.reset();
+        ArgMappedFile file;
+        if (!file.Open(filename, ArgMappedFile::kAccess::ReadOnly)) {
+            return false;
+        }
+        std::string_view source(file.Data(), file.Size());
+        // mostly one argument per line, reserving for the lines saves growing a large vector
+        tokens.reserve(ArgListSplitter::Count(source, '\n'));
+        text = std::make_unique_for_overwrite<char[]>(source.size() + 1);
+        ArgTokenizer::Tokenize(source.data(), source.data() + source.size(), text.get(), tokens);
+        return true;
     }
 
     [[nodiscard]]
-    int CountPresence(const std::string &shortParamName, const std::string &longParamName = {}) const {
-        // We need a specialized version here...
-        int nFound = 0;
-        for(size_t i=0;i<args.size();++i) {
-            std::string_view arg = args[i];
-            if (arg == stoparg) {
-                return nFound;
-            }
-            if (!IsValidArgument(arg)) {
+    std::span<const char * const> Tokens() const {
+        return tokens;
+    }
+
+private:
+    std::unique_ptr<char[]> text;
+    std::vector<const char *> tokens;
+};
+
+//
+// Hash index over the environment ('NAME=value' strings, like environ or the envp of main), built in a single pass.
+// Looking up many variables is then O(1) each instead of a scan of the environment per variable like getenv.
+// Values are slices of the environment strings, nothing is copied. The index is a snapshot - variables set after
+// Build are not seen and a variable changed after Build may leave its value dangling.
+//
+class ArgEnvironment {
+public:
+    void Build(const char *const *envp) {
+        size_t nVars = 0;
+        while((envp != nullptr) && (envp[nVars] != nullptr)) {
+            nVars++;
+        }
+        slots.assign(TableSize(nVars), {});
+        for(size_t i=0;i<nVars;i++) {
+            std::string_view var = envp[i];
+            auto idxSeparator = var.find('=');
+            if ((idxSeparator == std::string_view::npos) || (idxSeparator == 0)) {
                 continue;
             }
-
-            // simple check if we have a single parameter ('-a' or '--name') with/without arguments
-            if (arg == longParamName) {
-                nFound++;
-            } else {
-                // If this is a 'long' parameter - just skip it...
-                if ((arg.length() > 1) && (arg[0] == '-') && (arg[1] == '-')) continue;
-                // now check every letter in the argument and if they are present in our short parameter name
-                for (size_t j = 1; j < arg.length(); j++) {
-                    if (shortParamName.find(arg[j]) != std::string::npos) {
-                        nFound++;
-                    }
-                }
+            // the first definition wins, same as getenv
+            auto &slot = slots[ProbePos(var.substr(0, idxSeparator))];
+            if (slot.var == nullptr) {
+                slot.var = envp[i];
+                slot.lenName = idxSeparator;
             }
         }
-        return nFound;
+        bValid = true;
     }
 
-    template<typename TValue>
     [[nodiscard]]
-    int CopyEndArgs(std::vector<TValue> &outValues, bool append = true) const {
-
-        auto it = args.end()-1;
-        while((*it[0] != '-') && (it != args.begin())) --it;
-        std::string stopArg = *it;
-        // advance the argument
-        ++it;
-        // Now advance the number of arguments - must be previously parsed..
-        if (paramargs.contains(stopArg)) {
-            auto num = paramargs.at(stopArg);
-            for (int i=0;i<num;++i) {
-                ++it;
-            }
-        }
+    bool IsBuilt() const {
+        return bValid;
+    }
 
-        // are we at the end => nothing but prgname was supplied
-        // or is the argument now a '-<name>' which means there was no end-of-cmdline parameters passed
-        if ((it == args.end()) || (*it[0] == '-')) {
-            return 0;
+    // Value of the variable, empty if not set
+    [[nodiscard]]
+    std::optional<std::string_view> Find(std::string_view name) const {
+        if (slots.empty() || name.empty()) {
+            return {};
         }
-
-        if (!append) {
-            outValues.clear();
+        auto &slot = slots[ProbePos(name)];
+        if (slot.var == nullptr) {
+            return {};
         }
+        return std::string_view(slot.var + slot.lenName + 1);
+    }
 
-        int nValues = 0;
-        while(it != args.end()) {
-            auto res = convert_to<TValue>(*it);
-            if (!res.has_value()) {
-                return -1;
-            }
-            outValues.push_back(*res);
-            nValues++;
-            ++it;
-        }
+protected:
+    struct Slot {
+        const char *var = nullptr;
+        size_t lenName = 0;
+    };
 
-        return nValues;
+    static size_t TableSize(size_t nVars) {
+        // power of two, at most 50% load
+        size_t n = 16;
+        while(n < nVars * 2) n <<= 1;
+        return n;
     }
 
-    int CopyAllAfter(std::vector<std::string> &outValues, const std::string &param) const {
-        auto itParam = std::find_if(args.begin(), args.end(), [&](const std::string_view &arg) { return arg == param; });
-        if (itParam == args.end()) {
-            return -1;
-        }
-        ++itParam;
-        while(itParam != args.end()) {
-            outValues.push_back(*itParam);
-            ++itParam;
+    // linear probing, the slot either holds 'name' or is the empty slot where it should go
+    [[nodiscard]]
+    size_t ProbePos(std::string_view name) const {
+        size_t mask = slots.size() - 1;
+        size_t pos = std::hash<std::string_view>{}(name) & mask;
+        while((slots[pos].var != nullptr) && (std::string_view(slots[pos].var, slots[pos].lenName) != name)) {
+            pos = (pos + 1) & mask;
         }
-        return (int)outValues.size();
+        return pos;
     }
 
-    bool IsLastArgument(const std::string &shortParamName, const std::string &longParamName = {}) const {
-        auto it = args.end()-1;
+private:
+    std::vector<Slot> slots;
+    bool bValid = false;
+};
 
-        while(it != args.begin()) {
-            if ((*it[0] == '-') && ((*it == shortParamName) || (*it == longParamName))) {
-                return true;
-            }
-            if (*it[0] == '-') {
-                return false;
-            }
-            --it;
-        }
-        return false;
+// Name of an environment variable used when an option is not on the command line, like:
+//      argParser.TryParse(4, "-t", "--threads", ArgEnv("APP_THREADS"))
+struct ArgEnv {
+    constexpr explicit ArgEnv(std::string_view varName) : name(varName) {
     }
+    std::string_view name;
+};
 
-protected:
-    void update_paramargs(const std::string &shortParamName, const std::string &longParamName, int nCount) {
-        if (!shortParamName.empty()) {
-            if (paramargs.contains(shortParamName)) {
-                if (nCount > paramargs[shortParamName]) {
-                    paramargs[shortParamName] = nCount;
-                }
-            } else {
-                paramargs.insert({shortParamName, nCount});
-            }
+//
+// Config file ('key = value', INI style), mapped and parsed in place - keys and values are slices of the mapping.
+//  - one 'key = value' per line, whitespace around keys and values is trimmed
+//  - values may be quoted ("..." or '...') to keep whitespace, the quotes are removed - there are no escapes
+//  - '[section]' applies to the keys after it, 'port' after '[server]' is the key 'server.port'
+//  - lines starting with '#' or ';' are comments, there are no comments after a value
+//  - a key defined more than once takes the last value
+// The file is mapped read-only, nothing is copied or written and the pages stay shared with the page cache.
+// ArgParser resolves the long option
+// '--server.port' through the key 'server.port'.
+//
+class ArgConfigFile {
+public:
+    ArgConfigFile() = default;
+    virtual ~ArgConfigFile() = default;
+    ArgConfigFile(const ArgConfigFile &) = delete;
+    ArgConfigFile &operator=(const ArgConfigFile &) = delete;
 
+    // Map and parse the file, returns false if the file can't be read (or is 4GB or larger) or a line is
+    // malformed (see ErrorLine)
+    bool Open(const char *filename) {
+        entries.clear();
+        sections.clear();
+        slots.clear();
+        errorLine = 0;
+        if (!file.Open(filename, ArgMappedFile::kAccess::ReadOnly) || (file.Size() >= kNone)) {
+            file.Close();
+            return false;
         }
-        if (!longParamName.empty()) {
-            if (paramargs.contains(longParamName)) {
-                if (nCount > paramargs[longParamName]) {
-                    paramargs[longParamName] = nCount;
-                }
-            } else {
-                paramargs.insert({longParamName, nCount});
-            }
-        }
-    }
-    static bool IsValidArgument(const std::string_view &arg) {
-        if (arg.empty() || arg[0] != '-') {
+        if (!Parse(file.Data(), file.Data() + file.Size())) {
+            entries.clear();
+            sections.clear();
             return false;
         }
+        BuildIndex();
         return true;
     }
-    // Returns
-    //  false - indicates an error
-    //  true  - no error
-    template<typename TFunc>
+
+    // Line number (1 based) of the first malformed line, 0 if there is none
     [[nodiscard]]
-    kParseResult TryParseInternal(bool bHaveParam, TFunc cbParam, const std::string &shortParamName, const std::string &longParamName = {}) const {
-        for(size_t i=0;i<args.size();++i) {
-            std::string_view arg = args[i];
-            if (arg == stoparg) {
-                return kParseResult::OkNotPresent;
-            }
-            if (!IsValidArgument(arg)) {
-                continue;
-            }
+    size_t ErrorLine() const {
+        return errorLine;
+    }
 
-            // simple check if we have a single parameter ('-a' or '--name') with/without arguments
-            if ((arg == shortParamName) || (arg == longParamName)) {
-                // If we have params, make sure there are arguments left to support them...
-                if (bHaveParam && (i + 1) >= args.size()) {
-                    fprintf(stderr, "Argument missing for '%s' (check argc in CTOR)\n", shortParamName.c_str());
-                    return kParseResult::ErrMissingArg;
-                }
+    // Number of 'key = value' lines
+    [[nodiscard]]
+    size_t Count() const {
+        return entries.size();
+    }
 
-                // use callback to handle parameter
-                return cbParam(++i);
-            }
+    // Value of a key, like 'threads' or 'server.port' - empty if not defined
+    [[nodiscard]]
+    std::optional<std::string_view> Find(std::string_view key) const {
+        if (slots.empty()) {
+            return {};
+        }
+        auto idx = FindLast(key);
+        if (idx == kNone) {
+            return {};
+        }
+        return ValueAt(entries[idx].value);
+    }
 
-            // this is a long name - we do NOT check them for presence of short paramnames (used for flags)
-            if (arg.starts_with("--")) continue;
+protected:
+    static constexpr uint32_t kNone = UINT32_MAX;
 
-            //
-            // check if the parameter is embedded in a list of parameters (like '-b' in '-abc')
-            // Note: We DO NOT allow arguments here, by design...
-            //
-            for(size_t j=1;j<arg.length();j++) {
-                if (shortParamName.find(arg[j]) != std::string::npos) {
-                    // use callback to handle parameter, we could also simply return 'Ok' here
-                    // We can also simply return 'Ok' here
-                    return cbParam(++i);
+    // Offsets into the mapping, kept small - a large file has hundreds of thousands of them. The end of a value is
+    // only looked for when it is asked for.
+    struct Entry {
+        uint32_t hash;
+        uint32_t key;
+        uint32_t lenKey;
+        uint32_t value;
+    };
+
+    // Section names in file order with the first entry after them
+    struct Section {
+        uint32_t idxFirstEntry;
+        uint32_t name;
+        uint32_t lenName;
+    };
+
+    static bool IsSpace(char ch) {
+        return (ch == ' ') || (ch == '\t') || (ch == '\r');
+    }
+
+    // FNV-1a, a key continues from the hash of 'section.' so it hashes the same as the full name
+    static uint64_t Hash(std::string_view str, uint64_t hash = 14695981039346656037ull) {
+        for(auto ch : str) {
+            hash = (hash ^ static_cast<uint8_t>(ch)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    [[nodiscard]]
+    std::string_view KeyAt(const Entry &entry) const {
+        return {file.Data() + entry.key, entry.lenKey};
+    }
+
+    // Section of an entry, empty before the first section
+    [[nodiscard]]
+    std::string_view SectionOf(const Entry &entry) const {
+        auto idxEntry = static_cast<uint32_t>(&entry - entries.data());
+        auto it = std::upper_bound(sections.begin(), sections.end(), idxEntry, [](uint32_t idx, const Section &section) {
+            return idx < section.idxFirstEntry;
+        });
+        if (it == sections.begin()) {
+            return {};
+        }
+        --it;
+        return {file.Data() + it->name, it->lenName};
+    }
+
+    // The value from its first character to the end of the line, trimmed and unquoted
+    [[nodiscard]]
+    std::string_view ValueAt(uint32_t offset) const {
+        auto first = file.Data() + offset;
+        auto end = file.Data() + file.Size();
+        auto last = static_cast<const char *>(std::memchr(first, '\n', static_cast<size_t>(end - first)));
+        if (last == nullptr) {
+            last = end;
+        }
+        while((last > first) && IsSpace(last[-1])) last--;
+        if ((last - first >= 2) && ((*first == '"') || (*first == '\'')) && (last[-1] == *first)) {
+            first++;
+            last--;
+        }
+        return {first, static_cast<size_t>(last - first)};
+    }
+
+    // The full name 'section.key' compared without putting it together
+    [[nodiscard]]
+    bool IsKey(const Entry &entry, std::string_view name) const {
+        auto key = KeyAt(entry);
+        auto section = SectionOf(entry);
+        if (section.empty()) {
+            return key == name;
+        }
+        return (name.size() == section.size() + 1 + key.size()) && name.starts_with(section) &&
+               (name[section.size()] == '.') && name.ends_with(key);
+    }
+
+    bool Parse(const char *data, const char *end) {
+        std::string_view text(data, static_cast<size_t>(end - data));
+        // every entry is a line, reserving for all of them avoids growing a large vector
+        entries.reserve(ArgListSplitter::Count(text, '\n'));
+
+        uint64_t sectionHash = Hash({});
+        size_t nLine = 0;
+        auto cbLine = [&](std::string_view line) -> bool {
+            nLine++;
+            auto first = line.data();
+            auto last = line.data() + line.size();
+            while((first < last) && IsSpace(*first)) first++;
+            while((last > first) && IsSpace(last[-1])) last--;
+            if ((first == last) || (*first == '#') || (*first == ';')) {
+                return true;
+            }
+
+            if (*first == '[') {
+                if ((last - first < 2) || (last[-1] != ']')) {
+                    errorLine = nLine;
+                    return false;
                 }
+                first++;
+                last--;
+                while((first < last) && IsSpace(*first)) first++;
+                while((last > first) && IsSpace(last[-1])) last--;
+                std::string_view name(first, static_cast<size_t>(last - first));
+                sections.push_back({static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(first - data), static_cast<uint32_t>(name.size())});
+                sectionHash = name.empty() ? Hash({}) : Hash(".", Hash(name));
+                return true;
+            }
+
+            auto separator = static_cast<const char *>(std::memchr(first, '=', static_cast<size_t>(last - first)));
+            if (separator == nullptr) {
+                errorLine = nLine;
+                return false;
+            }
+            auto keyEnd = separator;
+            while((keyEnd > first) && IsSpace(keyEnd[-1])) keyEnd--;
+            if (keyEnd == first) {
+                errorLine = nLine;
+                return false;
             }
+            auto value = separator + 1;
+            while((value < last) && IsSpace(*value)) value++;
+            std::string_view key(first, static_cast<size_t>(keyEnd - first));
+            entries.push_back({static_cast<uint32_t>(Hash(key, sectionHash)), static_cast<uint32_t>(first - data),
+                               static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value - data)});
+            return true;
+        };
+        // lines are found with the same vectorized separator scan as lists
+        return ArgListSplitter::Split(text, '\n', cbLine);
+    }
 
+    // Every entry goes into the table, duplicates included - keys are only compared on lookup which picks the
+    // last definition. Insertion never touches the text, a large file is indexed in one sequential pass.
+    void BuildIndex() {
+        // power of two, at most 50% load
+        size_t n = 16;
+        while(n < entries.size() * 2) n <<= 1;
+        slots.assign(n, kNone);
+        size_t mask = slots.size() - 1;
+        for(size_t i=0;i<entries.size();i++) {
+            size_t pos = entries[i].hash & mask;
+            while(slots[pos] != kNone) {
+                pos = (pos + 1) & mask;
+            }
+            slots[pos] = static_cast<uint32_t>(i);
         }
-        return kParseResult::OkNotPresent;
     }
 
-    template<typename T>
+    // Index of the last definition of 'key', kNone if not defined. '[a] b.c' and '[a.b] c' both define 'a.b.c',
+    // the full name hashes the same for both.
     [[nodiscard]]
-    std::optional<T> convert_to(std::string_view sv) const {
-        //T value;
+    uint32_t FindLast(std::string_view key) const {
+        auto hash = static_cast<uint32_t>(Hash(key));
+        size_t mask = slots.size() - 1;
+        uint32_t idxLast = kNone;
+        for(size_t pos = hash & mask; slots[pos] != kNone; pos = (pos + 1) & mask) {
+            auto idx = slots[pos];
+            if ((entries[idx].hash == hash) && ((idxLast == kNone) || (idx > idxLast)) && IsKey(entries[idx], key)) {
+                idxLast = idx;
+            }
+        }
+        return idxLast;
+    }
 
-        if constexpr (std::is_same_v<T, std::string>) {
-            return std::string{sv};
+private:
+    ArgMappedFile file;
+    std::vector<Entry> entries;
+    std::vector<Section> sections;
+    std::vector<uint32_t> slots;
+    size_t errorLine = 0;
+};
+
+//
+// 128 bit approximations of 5^q for q = -342..308 (most significant bit set, truncated for q >= 0 and rounded up
+// for q < 0), two 64 bit words per power. Used by the Eisel-Lemire float parser in ArgNumberParser.
+//
+struct ArgPowersOfFive {
+    static constexpr int kSmallest = -342;
+    static constexpr int kLargest = 308;
+    static constexpr uint64_t table[2 * (kLargest - kSmallest + 1)] = {
+        0xeef453d6923bd65aull, 0x113faa2906a13b3full, // 5^-342
+        0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull, // 5^-341
+        0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull, // 5^-340
+        0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull, // 5^-339
+        0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull, // 5^-338
+        0xb64ec836a47146f9ull, 0x9748e2826cdee284ull, // 5^-337
+        0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull, // 5^-336
+        0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull, // 5^-335
+        0xb208ef855c969f4full, 0xbdbd2d335e51a935ull, // 5^-334
+        0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull, // 5^-333
+        0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull, // 5^-332
+        0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull, // 5^-331
+        0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull, // 5^-330
+        0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull, // 5^-329
+        0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull, // 5^-328
+        0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull, // 5^-327
+        0x84a57695fe98746dull, 0x014bb630f7604b57ull, // 5^-326
+        0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull, // 5^-325
+        0xcf42894a5dce35eaull, 0x52064cac828675b9ull, // 5^-324
+        0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull, // 5^-323
+        0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull, // 5^-322
+        0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull, // 5^-321
+        0xfd00b897478238d0ull, 0x8920b098955522b4ull, // 5^-320
+        0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull, // 5^-319
+        0xc5a890362fddbc62ull, 0xeb2189f734aa831dull, // 5^-318
+        0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull, // 5^-317
+        0x9a6bb0aa55653b2dull, 0x47b233c92125366eull, // 5^-316
+        0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull, // 5^-315
+        0xf148440a256e2c76ull, 0xc00670ea43ca250dull, // 5^-314
+        0x96cd2a865764dbcaull, 0x380406926a5e5728ull, // 5^-313
+        0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull, // 5^-312
+        0xeba09271e88d976bull, 0xf7864a44c633682eull, // 5^-311
+        0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull, // 5^-310
+        0xb8157268fdae9e4cull, 0x5960ea05bad82964ull, // 5^-309
+        0xe61acf033d1a45dfull, 0x6fb92487298e33bdull, // 5^-308
+        0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull, // 5^-307
+        0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull, // 5^-306
+        0xe0b62e2929aba83cull, 0x331acdabfe94de87ull, // 5^-305
+        0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull, // 5^-304
+        0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull, // 5^-303
+        0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull, // 5^-302
+        0x892731ac9faf056eull, 0xbe311c083a225cd2ull, // 5^-301
+        0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull, // 5^-300
+        0xd64d3d9db981787dull, 0x092cbbccdad5b108ull, // 5^-299
+        0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull, // 5^-298
+        0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull, // 5^-297
+        0xd1476e2c07286faaull, 0x1af5af660db4aee1ull, // 5^-296
+        0x82cca4db847945caull, 0x50d98d9fc890ed4dull, // 5^-295
+        0xa37fce126597973cull, 0xe50ff107bab528a0ull, // 5^-294
+        0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull, // 5^-293
+        0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull, // 5^-292
+        0x9faacf3df73609b1ull, 0x77b191618c54e9acull, // 5^-291
+        0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull, // 5^-290
+        0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull, // 5^-289
+        0x9becce62836ac577ull, 0x4ee367f9430aec32ull, // 5^-288
+        0xc2e801fb244576d5ull, 0x229c41f793cda73full, // 5^-287
+        0xf3a20279ed56d48aull, 0x6b43527578c1110full, // 5^-286
+        0x9845418c345644d6ull, 0x830a13896b78aaa9ull, // 5^-285
+        0xbe5691ef416bd60cull, 0x23cc986bc656d553ull, // 5^-284
+        0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull, // 5^-283
+        0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull, // 5^-282
+        0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull, // 5^-281
+        0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull, // 5^-280
+        0x91376c36d99995beull, 0x23100809b9c21fa1ull, // 5^-279
+        0xb58547448ffffb2dull, 0xabd40a0c2832a78aull, // 5^-278
+        0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull, // 5^-277
+        0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull, // 5^-276
+        0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull, // 5^-275
+        0xdd95317f31c7fa1dull, 0x40405643d711d583ull, // 5^-274
+        0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull, // 5^-273
+        0xad1c8eab5ee43b66ull, 0xda3243650005eecfull, // 5^-272
+        0xd863b256369d4a40ull, 0x90bed43e40076a82ull, // 5^-271
+        0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull, // 5^-270
+        0xa90de3535aaae202ull, 0x711515d0a205cb36ull, // 5^-269
+        0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull, // 5^-268
+        0x8412d9991ed58091ull, 0xe858790afe9486c2ull, // 5^-267
+        0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull, // 5^-266
+        0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full, // 5^-265
+        0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull, // 5^-264
+        0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull, // 5^-263
+        0xc987434744ac874eull, 0xa327ffb266b56220ull, // 5^-262
+        0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull, // 5^-261
+        0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull, // 5^-260
+        0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull, // 5^-259
+        0xf6019da07f549b2bull, 0x7e2a53a146606a48ull, // 5^-258
+        0x99c102844f94e0fbull, 0x2eda7444cbfc426dull, // 5^-257
+        0xc0314325637a1939ull, 0xfa911155fefb5308ull, // 5^-256
+        0xf03d93eebc589f88ull, 0x793555ab7eba27caull, // 5^-255
+        0x96267c7535b763b5ull, 0x4bc1558b2f3458deull, // 5^-254
+        0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull, // 5^-253
+        0xea9c227723ee8bcbull, 0x465e15a979c1cadcull, // 5^-252
+        0x92a1958a7675175full, 0x0bfacd89ec191ec9ull, // 5^-251
+        0xb749faed14125d36ull, 0xcef980ec671f667bull, // 5^-250
+        0xe51c79a85916f484ull, 0x82b7e12780e7401aull, // 5^-249
+        0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull, // 5^-248
+        0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull, // 5^-247
+        0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull, // 5^-246
+        0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull, // 5^-245
+        0xaecc49914078536dull, 0x58fae9f773886e18ull, // 5^-244
+        0xda7f5bf590966848ull, 0xaf39a475506a899eull, // 5^-243
+        0x888f99797a5e012dull, 0x6d8406c952429603ull, // 5^-242
+        0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull, // 5^-241
+        0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull, // 5^-240
+        0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full, // 5^-239
+        0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull, // 5^-238
+        0xd0601d8efc57b08bull, 0xf13b94daf124da26ull, // 5^-237
+        0x823c12795db6ce57ull, 0x76c53d08d6b70858ull, // 5^-236
+        0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull, // 5^-235
+        0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull, // 5^-234
+        0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull, // 5^-233
+        0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull, // 5^-232
+        0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull, // 5^-231
+        0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull, // 5^-230
+        0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull, // 5^-229
+        0xc21094364dfb5636ull, 0x985915fc12f542e4ull, // 5^-228
+        0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull, // 5^-227
+        0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull, // 5^-226
+        0xbd8430bd08277231ull, 0x50c6ff782a838353ull, // 5^-225
+        0xece53cec4a314ebdull, 0xa4f8bf5635246428ull, // 5^-224
+        0x940f4613ae5ed136ull, 0x871b7795e136be99ull, // 5^-223
+        0xb913179899f68584ull, 0x28e2557b59846e3full, // 5^-222
+        0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull, // 5^-221
+        0x9096ea6f3848984full, 0x3ff0d2c85def7621ull, // 5^-220
+        0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull, // 5^-219
+        0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull, // 5^-218
+        0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull, // 5^-217
+        0xb080392cc4349decull, 0xbd8d794d96aacfb3ull, // 5^-216
+        0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull, // 5^-215
+        0x89e42caaf9491b60ull, 0xf41686c49db57244ull, // 5^-214
+        0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull, // 5^-213
+        0xd77485cb25823ac7ull, 0x7d633293366b828bull, // 5^-212
+        0x86a8d39ef77164bcull, 0xae5dff9c02033197ull, // 5^-211
+        0xa8530886b54dbdebull, 0xd9f57f830283fdfcull, // 5^-210
+        0xd267caa862a12d66ull, 0xd072df63c324fd7bull, // 5^-209
+        0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull, // 5^-208
+        0xa46116538d0deb78ull, 0x52d9be85f074e608ull, // 5^-207
+        0xcd795be870516656ull, 0x67902e276c921f8bull, // 5^-206
+        0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull, // 5^-205
+        0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull, // 5^-204
+        0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull, // 5^-203
+        0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull, // 5^-202
+        0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull, // 5^-201
+        0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull, // 5^-200
+        0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull, // 5^-199
+        0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull, // 5^-198
+        0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull, // 5^-197
+        0xef340a98172aace4ull, 0x86fb897116c87c34ull, // 5^-196
+        0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull, // 5^-195
+        0xbae0a846d2195712ull, 0x8974836059cca109ull, // 5^-194
+        0xe998d258869facd7ull, 0x2bd1a438703fc94bull, // 5^-193
+        0x91ff83775423cc06ull, 0x7b6306a34627ddcfull, // 5^-192
+        0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull, // 5^-191
+        0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull, // 5^-190
+        0x8e938662882af53eull, 0x547eb47b7282ee9cull, // 5^-189
+        0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull, // 5^-188
+        0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull, // 5^-187
+        0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull, // 5^-186
+        0xae0b158b4738705eull, 0x9624ab50b148d445ull, // 5^-185
+        0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull, // 5^-184
+        0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull, // 5^-183
+        0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull, // 5^-182
+        0xd47487cc8470652bull, 0x7647c3200069671full, // 5^-181
+        0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull, // 5^-180
+        0xa5fb0a17c777cf09ull, 0xf468107100525890ull, // 5^-179
+        0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull, // 5^-178
+        0x81ac1fe293d599bfull, 0xc6f14cd848405530ull, // 5^-177
+        0xa21727db38cb002full, 0xb8ada00e5a506a7cull, // 5^-176
+        0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull, // 5^-175
+        0xfd442e4688bd304aull, 0x908f4a166d1da663ull, // 5^-174
+        0x9e4a9cec15763e2eull, 0x9a598e4e043287feull, // 5^-173
+        0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull, // 5^-172
+        0xf7549530e188c128ull, 0xd12bee59e68ef47cull, // 5^-171
+        0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull, // 5^-170
+        0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull, // 5^-169
+        0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull, // 5^-168
+        0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull, // 5^-167
+        0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull, // 5^-166
+        0xebdf661791d60f56ull, 0x111b495b3464ad21ull, // 5^-165
+        0x936b9fcebb25c995ull, 0xcab10dd900beec34ull, // 5^-164
+        0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull, // 5^-163
+        0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull, // 5^-162
+        0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull, // 5^-161
+        0xb3f4e093db73a093ull, 0x59ed216765690f56ull, // 5^-160
+        0xe0f218b8d25088b8ull, 0x306869c13ec3532cull, // 5^-159
+        0x8c974f7383725573ull, 0x1e414218c73a13fbull, // 5^-158
+        0xafbd2350644eeacfull, 0xe5d1929ef90898faull, // 5^-157
+        0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull, // 5^-156
+        0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull, // 5^-155
+        0xab9eb47c81f5114full, 0x066ea92f3f326564ull, // 5^-154
+        0xd686619ba27255a2ull, 0xc80a537b0efefebdull, // 5^-153
+        0x8613fd0145877585ull, 0xbd06742ce95f5f36ull, // 5^-152
+        0xa798fc4196e952e7ull, 0x2c48113823b73704ull, // 5^-151
+        0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull, // 5^-150
+        0x82ef85133de648c4ull, 0x9a984d73dbe722fbull, // 5^-149
+        0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull, // 5^-148
+        0xcc963fee10b7d1b3ull, 0x318df905079926a8ull, // 5^-147
+        0xffbbcfe994e5c61full, 0xfdf17746497f7052ull, // 5^-146
+        0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull, // 5^-145
+        0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull, // 5^-144
+        0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull, // 5^-143
+        0x9c1661a651213e2dull, 0x06bea10ca65c084eull, // 5^-142
+        0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull, // 5^-141
+        0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull, // 5^-140
+        0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull, // 5^-139
+        0xbe89523386091465ull, 0xf6bbb397f1135823ull, // 5^-138
+        0xee2ba6c0678b597full, 0x746aa07ded582e2cull, // 5^-137
+        0x94db483840b717efull, 0xa8c2a44eb4571cdcull, // 5^-136
+        0xba121a4650e4ddebull, 0x92f34d62616ce413ull, // 5^-135
+        0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull, // 5^-134
+        0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull, // 5^-133
+        0xb5b5ada8aaff80b8ull, 0x0d819992132456baull, // 5^-132
+        0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull, // 5^-131
+        0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull, // 5^-130
+        0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull, // 5^-129
+        0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull, // 5^-128
+        0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull, // 5^-127
+        0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull, // 5^-126
+        0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull, // 5^-125
+        0x87625f056c7c4a8bull, 0x11471cd764ad4972ull, // 5^-124
+        0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull, // 5^-123
+        0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull, // 5^-122
+        0x843610cb4bf160cbull, 0xcedf722a585139baull, // 5^-121
+        0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull, // 5^-120
+        0xce947a3da6a9273eull, 0x733d226229feea32ull, // 5^-119
+        0x811ccc668829b887ull, 0x0806357d5a3f525full, // 5^-118
+        0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull, // 5^-117
+        0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull, // 5^-116
+        0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull, // 5^-115
+        0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull, // 5^-114
+        0xc5029163f384a931ull, 0x0a9e795e65d4df11ull, // 5^-113
+        0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull, // 5^-112
+        0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull, // 5^-111
+        0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull, // 5^-110
+        0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull, // 5^-109
+        0x964e858c91ba2655ull, 0x3a6a07f8d510f86full, // 5^-108
+        0xbbe226efb628afeaull, 0x890489f70a55368bull, // 5^-107
+        0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull, // 5^-106
+        0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull, // 5^-105
+        0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull, // 5^-104
+        0xe55990879ddcaabdull, 0xcc420a6a101d0515ull, // 5^-103
+        0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull, // 5^-102
+        0xb32df8e9f3546564ull, 0x47939822dc96abf9ull, // 5^-101
+        0xdff9772470297ebdull, 0x59787e2b93bc56f7ull, // 5^-100
+        0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull, // 5^-99
+        0xaefae51477a06b03ull, 0xede622920b6b23f1ull, // 5^-98
+        0xdab99e59958885c4ull, 0xe95fab368e45ecedull, // 5^-97
+        0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull, // 5^-96
+        0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull, // 5^-95
+        0xd59944a37c0752a2ull, 0x4be76d3346f0495full, // 5^-94
+        0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull, // 5^-93
+        0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull, // 5^-92
+        0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull, // 5^-91
+        0x825ecc24c873782full, 0x8ed400668c0c28c8ull, // 5^-90
+        0xa2f67f2dfa90563bull, 0x728900802f0f32faull, // 5^-89
+        0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull, // 5^-88
+        0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull, // 5^-87
+        0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull, // 5^-86
+        0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull, // 5^-85
+        0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull, // 5^-84
+        0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull, // 5^-83
+        0xc24452da229b021bull, 0xfbe85badce996168ull, // 5^-82
+        0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull, // 5^-81
+        0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull, // 5^-80
+        0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull, // 5^-79
+        0xed246723473e3813ull, 0x290123e9aab23b68ull, // 5^-78
+        0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull, // 5^-77
+        0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull, // 5^-76
+        0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull, // 5^-75
+        0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull, // 5^-74
+        0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull, // 5^-73
+        0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull, // 5^-72
+        0x8d590723948a535full, 0x579c487e5a38ad0eull, // 5^-71
+        0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull, // 5^-70
+        0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull, // 5^-69
+        0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull, // 5^-68
+        0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full, // 5^-67
+        0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full, // 5^-66
+        0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull, // 5^-65
+        0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull, // 5^-64
+        0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull, // 5^-63
+        0x83a3eeeef9153e89ull, 0x1953cf68300424acull, // 5^-62
+        0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull, // 5^-61
+        0xcdb02555653131b6ull, 0x3792f412cb06794dull, // 5^-60
+        0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull, // 5^-59
+        0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull, // 5^-58
+        0xc8de047564d20a8bull, 0xf245825a5a445275ull, // 5^-57
+        0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull, // 5^-56
+        0x9ced737bb6c4183dull, 0x55464dd69685606bull, // 5^-55
+        0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull, // 5^-54
+        0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull, // 5^-53
+        0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull, // 5^-52
+        0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull, // 5^-51
+        0xef73d256a5c0f77cull, 0x963e66858f6d4440ull, // 5^-50
+        0x95a8637627989aadull, 0xdde7001379a44aa8ull, // 5^-49
+        0xbb127c53b17ec159ull, 0x5560c018580d5d52ull, // 5^-48
+        0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull, // 5^-47
+        0x9226712162ab070dull, 0xcab3961304ca70e8ull, // 5^-46
+        0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull, // 5^-45
+        0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull, // 5^-44
+        0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull, // 5^-43
+        0xb267ed1940f1c61cull, 0x55f038b237591ed3ull, // 5^-42
+        0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull, // 5^-41
+        0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull, // 5^-40
+        0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull, // 5^-39
+        0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull, // 5^-38
+        0x881cea14545c7575ull, 0x7e50d64177da2e54ull, // 5^-37
+        0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull, // 5^-36
+        0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull, // 5^-35
+        0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull, // 5^-34
+        0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull, // 5^-33
+        0xcfb11ead453994baull, 0x67de18eda5814af2ull, // 5^-32
+        0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull, // 5^-31
+        0xa2425ff75e14fc31ull, 0xa1258379a94d028dull, // 5^-30
+        0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull, // 5^-29
+        0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull, // 5^-28
+        0x9e74d1b791e07e48ull, 0x775ea264cf55347eull, // 5^-27
+        0xc612062576589ddaull, 0x95364afe032a819eull, // 5^-26
+        0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull, // 5^-25
+        0x9abe14cd44753b52ull, 0xc4926a9672793543ull, // 5^-24
+        0xc16d9a0095928a27ull, 0x75b7053c0f178294ull, // 5^-23
+        0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull, // 5^-22
+        0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull, // 5^-21
+        0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull, // 5^-20
+        0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull, // 5^-19
+        0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull, // 5^-18
+        0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull, // 5^-17
+        0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull, // 5^-16
+        0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull, // 5^-15
+        0xb424dc35095cd80full, 0x538484c19ef38c95ull, // 5^-14
+        0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull, // 5^-13
+        0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull, // 5^-12
+        0xafebff0bcb24aafeull, 0xf78f69a51539d749ull, // 5^-11
+        0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull, // 5^-10
+        0x89705f4136b4a597ull, 0x31680a88f8953031ull, // 5^-9
+        0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull, // 5^-8
+        0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull, // 5^-7
+        0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull, // 5^-6
+        0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull, // 5^-5
+        0xd1b71758e219652bull, 0xd3c36113404ea4a9ull, // 5^-4
+        0x83126e978d4fdf3bull, 0x645a1cac083126eaull, // 5^-3
+        0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull, // 5^-2
+        0xccccccccccccccccull, 0xcccccccccccccccdull, // 5^-1
+        0x8000000000000000ull, 0x0000000000000000ull, // 5^0
+        0xa000000000000000ull, 0x0000000000000000ull, // 5^1
+        0xc800000000000000ull, 0x0000000000000000ull, // 5^2
+        0xfa00000000000000ull, 0x0000000000000000ull, // 5^3
+        0x9c40000000000000ull, 0x0000000000000000ull, // 5^4
+        0xc350000000000000ull, 0x0000000000000000ull, // 5^5
+        0xf424000000000000ull, 0x0000000000000000ull, // 5^6
+        0x9896800000000000ull, 0x0000000000000000ull, // 5^7
+        0xbebc200000000000ull, 0x0000000000000000ull, // 5^8
+        0xee6b280000000000ull, 0x0000000000000000ull, // 5^9
+        0x9502f90000000000ull, 0x0000000000000000ull, // 5^10
+        0xba43b74000000000ull, 0x0000000000000000ull, // 5^11
+        0xe8d4a51000000000ull, 0x0000000000000000ull, // 5^12
+        0x9184e72a00000000ull, 0x0000000000000000ull, // 5^13
+        0xb5e620f480000000ull, 0x0000000000000000ull, // 5^14
+        0xe35fa931a0000000ull, 0x0000000000000000ull, // 5^15
+        0x8e1bc9bf04000000ull, 0x0000000000000000ull, // 5^16
+        0xb1a2bc2ec5000000ull, 0x0000000000000000ull, // 5^17
+        0xde0b6b3a76400000ull, 0x0000000000000000ull, // 5^18
+        0x8ac7230489e80000ull, 0x0000000000000000ull, // 5^19
+        0xad78ebc5ac620000ull, 0x0000000000000000ull, // 5^20
+        0xd8d726b7177a8000ull, 0x0000000000000000ull, // 5^21
+        0x878678326eac9000ull, 0x0000000000000000ull, // 5^22
+        0xa968163f0a57b400ull, 0x0000000000000000ull, // 5^23
+        0xd3c21bcecceda100ull, 0x0000000000000000ull, // 5^24
+        0x84595161401484a0ull, 0x0000000000000000ull, // 5^25
+        0xa56fa5b99019a5c8ull, 0x0000000000000000ull, // 5^26
+        0xcecb8f27f4200f3aull, 0x0000000000000000ull, // 5^27
+        0x813f3978f8940984ull, 0x4000000000000000ull, // 5^28
+        0xa18f07d736b90be5ull, 0x5000000000000000ull, // 5^29
+        0xc9f2c9cd04674edeull, 0xa400000000000000ull, // 5^30
+        0xfc6f7c4045812296ull, 0x4d00000000000000ull, // 5^31
+        0x9dc5ada82b70b59dull, 0xf020000000000000ull, // 5^32
+        0xc5371912364ce305ull, 0x6c28000000000000ull, // 5^33
+        0xf684df56c3e01bc6ull, 0xc732000000000000ull, // 5^34
+        0x9a130b963a6c115cull, 0x3c7f400000000000ull, // 5^35
+        0xc097ce7bc90715b3ull, 0x4b9f100000000000ull, // 5^36
+        0xf0bdc21abb48db20ull, 0x1e86d40000000000ull, // 5^37
+        0x96769950b50d88f4ull, 0x1314448000000000ull, // 5^38
+        0xbc143fa4e250eb31ull, 0x17d955a000000000ull, // 5^39
+        0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull, // 5^40
+        0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull, // 5^41
+        0xb7abc627050305adull, 0xf14a3d9e40000000ull, // 5^42
+        0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull, // 5^43
+        0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull, // 5^44
+        0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull, // 5^45
+        0xe0352f62a19e306eull, 0xd50b2037ad200000ull, // 5^46
+        0x8c213d9da502de45ull, 0x4526f422cc340000ull, // 5^47
+        0xaf298d050e4395d6ull, 0x9670b12b7f410000ull, // 5^48
+        0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull, // 5^49
+        0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull, // 5^50
+        0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull, // 5^51
+        0xd5d238a4abe98068ull, 0x72a4904598d6d880ull, // 5^52
+        0x85a36366eb71f041ull, 0x47a6da2b7f864750ull, // 5^53
+        0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull, // 5^54
+        0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull, // 5^55
+        0x82818f1281ed449full, 0xbff8f10e7a8921a4ull, // 5^56
+        0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull, // 5^57
+        0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull, // 5^58
+        0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull, // 5^59
+        0x9f4f2726179a2245ull, 0x01d762422c946590ull, // 5^60
+        0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull, // 5^61
+        0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull, // 5^62
+        0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full, // 5^63
+        0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull, // 5^64
+        0xf316271c7fc3908aull, 0x8bef464e3945ef7aull, // 5^65
+        0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull, // 5^66
+        0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull, // 5^67
+        0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull, // 5^68
+        0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull, // 5^69
+        0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull, // 5^70
+        0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull, // 5^71
+        0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull, // 5^72
+        0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull, // 5^73
+        0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull, // 5^74
+        0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull, // 5^75
+        0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull, // 5^76
+        0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull, // 5^77
+        0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull, // 5^78
+        0xacb92ed9397bf996ull, 0x49c2c37f07965404ull, // 5^79
+        0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull, // 5^80
+        0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull, // 5^81
+        0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull, // 5^82
+        0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull, // 5^83
+        0x83c7088e1aab65dbull, 0x792667c6da79e0faull, // 5^84
+        0xa4b8cab1a1563f52ull, 0x577001b891185938ull, // 5^85
+        0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull, // 5^86
+        0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull, // 5^87
+        0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull, // 5^88
+        0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull, // 5^89
+        0xfb5878494ace3a5full, 0x04ab48a04065c723ull, // 5^90
+        0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull, // 5^91
+        0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull, // 5^92
+        0xf5746577930d6500ull, 0xca8f44ec7ee36479ull, // 5^93
+        0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull, // 5^94
+        0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull, // 5^95
+        0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull, // 5^96
+        0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull, // 5^97
+        0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull, // 5^98
+        0xea1575143cf97226ull, 0xf52d09d71a3293bdull, // 5^99
+        0x924d692ca61be758ull, 0x593c2626705f9c56ull, // 5^100
+        0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull, // 5^101
+        0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull, // 5^102
+        0x8edf98b59a373fecull, 0x4724bd4189bd5eacull, // 5^103
+        0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull, // 5^104
+        0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull, // 5^105
+        0x8b865b215899f46cull, 0xbd79e0d20082ee74ull, // 5^106
+        0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull, // 5^107
+        0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull, // 5^108
+        0x884134fe908658b2ull, 0x3109058d147fdcddull, // 5^109
+        0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull, // 5^110
+        0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull, // 5^111
+        0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull, // 5^112
+        0xa6539930bf6bff45ull, 0x84db8346b786151cull, // 5^113
+        0xcfe87f7cef46ff16ull, 0xe612641865679a63ull, // 5^114
+        0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull, // 5^115
+        0xa26da3999aef7749ull, 0xe3be5e330f38f09dull, // 5^116
+        0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull, // 5^117
+        0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull, // 5^118
+        0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull, // 5^119
+        0xc646d63501a1511dull, 0xb281e1fd541501b8ull, // 5^120
+        0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull, // 5^121
+        0x9ae757596946075full, 0x3375788de9b06958ull, // 5^122
+        0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull, // 5^123
+        0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull, // 5^124
+        0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull, // 5^125
+        0xbd176620a501fbffull, 0xb650e5a93bc3d898ull, // 5^126
+        0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull, // 5^127
+        0x93ba47c980e98cdfull, 0xc66f336c36b10137ull, // 5^128
+        0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull, // 5^129
+        0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull, // 5^130
+        0x9043ea1ac7e41392ull, 0x87c89837ad68db2full, // 5^131
+        0xb454e4a179dd1877ull, 0x29babe4598c311fbull, // 5^132
+        0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull, // 5^133
+        0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull, // 5^134
+        0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full, // 5^135
+        0xdc21a1171d42645dull, 0x76707543f4fa1f73ull, // 5^136
+        0x899504ae72497ebaull, 0x6a06494a791c53a8ull, // 5^137
+        0xabfa45da0edbde69ull, 0x0487db9d17636892ull, // 5^138
+        0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull, // 5^139
+        0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull, // 5^140
+        0xa7f26836f282b732ull, 0x8e6cac7768d7141eull, // 5^141
+        0xd1ef0244af2364ffull, 0x3207d795430cd926ull, // 5^142
+        0x8335616aed761f1full, 0x7f44e6bd49e807b8ull, // 5^143
+        0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull, // 5^144
+        0xcd036837130890a1ull, 0x36dba887c37a8c0full, // 5^145
+        0x802221226be55a64ull, 0xc2494954da2c9789ull, // 5^146
+        0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull, // 5^147
+        0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull, // 5^148
+        0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull, // 5^149
+        0x9c69a97284b578d7ull, 0xff2a760414536efbull, // 5^150
+        0xc38413cf25e2d70dull, 0xfef5138519684abaull, // 5^151
+        0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull, // 5^152
+        0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull, // 5^153
+        0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull, // 5^154
+        0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull, // 5^155
+        0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull, // 5^156
+        0xba756174393d88dfull, 0x94f971119aeef9e4ull, // 5^157
+        0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull, // 5^158
+        0x91abb422ccb812eeull, 0xac62e055c10ab33aull, // 5^159
+        0xb616a12b7fe617aaull, 0x577b986b314d6009ull, // 5^160
+        0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull, // 5^161
+        0x8e41ade9fbebc27dull, 0x14588f13be847307ull, // 5^162
+        0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull, // 5^163
+        0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull, // 5^164
+        0x8aec23d680043beeull, 0x25de7bb9480d5854ull, // 5^165
+        0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull, // 5^166
+        0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull, // 5^167
+        0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull, // 5^168
+        0xa99541bf57452b28ull, 0x353a1607ac744a53ull, // 5^169
+        0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull, // 5^170
+        0x847c9b5d7c2e09b7ull, 0x69956135febada11ull, // 5^171
+        0xa59bc234db398c25ull, 0x43fab9837e699095ull, // 5^172
+        0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull, // 5^173
+        0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull, // 5^174
+        0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull, // 5^175
+        0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull, // 5^176
+        0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull, // 5^177
+        0x9defbf01b061adabull, 0x3a0888136afa64a7ull, // 5^178
+        0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull, // 5^179
+        0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull, // 5^180
+        0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull, // 5^181
+        0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull, // 5^182
+        0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull, // 5^183
+        0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull, // 5^184
+        0xbc4665b596706114ull, 0x873d5d9f0dde1feeull, // 5^185
+        0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull, // 5^186
+        0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull, // 5^187
+        0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full, // 5^188
+        0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull, // 5^189
+        0x8fa475791a569d10ull, 0xf96e017d694487bcull, // 5^190
+        0xb38d92d760ec4455ull, 0x37c981dcc395a9acull, // 5^191
+        0xe070f78d3927556aull, 0x85bbe253f47b1417ull, // 5^192
+        0x8c469ab843b89562ull, 0x93956d7478ccec8eull, // 5^193
+        0xaf58416654a6babbull, 0x387ac8d1970027b2ull, // 5^194
+        0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull, // 5^195
+        0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull, // 5^196
+        0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull, // 5^197
+        0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull, // 5^198
+        0x85c7056562757456ull, 0xf6872d5667844e49ull, // 5^199
+        0xa738c6bebb12d16cull, 0xb428f8ac016561dbull, // 5^200
+        0xd106f86e69d785c7ull, 0xe13336d701beba52ull, // 5^201
+        0x82a45b450226b39cull, 0xecc0024661173473ull, // 5^202
+        0xa34d721642b06084ull, 0x27f002d7f95d0190ull, // 5^203
+        0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull, // 5^204
+        0xff290242c83396ceull, 0x7e67047175a15271ull, // 5^205
+        0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull, // 5^206
+        0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull, // 5^207
+        0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull, // 5^208
+        0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull, // 5^209
+        0xc2abf989935ddbfeull, 0x6acff893d00ea435ull, // 5^210
+        0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull, // 5^211
+        0x98165af37b2153deull, 0xc3727a337a8b704aull, // 5^212
+        0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull, // 5^213
+        0xeda2ee1c7064130cull, 0x1162def06f79df73ull, // 5^214
+        0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull, // 5^215
+        0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull, // 5^216
+        0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull, // 5^217
+        0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull, // 5^218
+        0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull, // 5^219
+        0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull, // 5^220
+        0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull, // 5^221
+        0xb10d8e1456105dadull, 0x7425a83e872c5f47ull, // 5^222
+        0xdd50f1996b947518ull, 0xd12f124e28f77719ull, // 5^223
+        0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full, // 5^224
+        0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull, // 5^225
+        0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull, // 5^226
+        0x8714a775e3e95c78ull, 0x65acfaec34810a71ull, // 5^227
+        0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull, // 5^228
+        0xd31045a8341ca07cull, 0x1ede48111209a050ull, // 5^229
+        0x83ea2b892091e44dull, 0x934aed0aab460432ull, // 5^230
+        0xa4e4b66b68b65d60ull, 0xf81da84d5617853full, // 5^231
+        0xce1de40642e3f4b9ull, 0x36251260ab9d668eull, // 5^232
+        0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull, // 5^233
+        0xa1075a24e4421730ull, 0xb24cf65b8612f81full, // 5^234
+        0xc94930ae1d529cfcull, 0xdee033f26797b627ull, // 5^235
+        0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull, // 5^236
+        0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull, // 5^237
+        0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull, // 5^238
+        0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull, // 5^239
+        0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull, // 5^240
+        0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull, // 5^241
+        0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull, // 5^242
+        0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull, // 5^243
+        0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull, // 5^244
+        0xea53df5fd18d5513ull, 0x84c86189216dc5edull, // 5^245
+        0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull, // 5^246
+        0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull, // 5^247
+        0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull, // 5^248
+        0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull, // 5^249
+        0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull, // 5^250
+        0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull, // 5^251
+        0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull, // 5^252
+        0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull, // 5^253
+        0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull, // 5^254
+        0x8865899617fb1871ull, 0x7e2fa67c7a658892ull, // 5^255
+        0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull, // 5^256
+        0xd51ea6fa85785631ull, 0x552a74227f3ea565ull, // 5^257
+        0x8533285c936b35deull, 0xd53a88958f87275full, // 5^258
+        0xa67ff273b8460356ull, 0x8a892abaf368f137ull, // 5^259
+        0xd01fef10a657842cull, 0x2d2b7569b0432d85ull, // 5^260
+        0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull, // 5^261
+        0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full, // 5^262
+        0xcb3f2f7642717713ull, 0x241c70a936219a73ull, // 5^263
+        0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull, // 5^264
+        0x9ec95d1463e8a506ull, 0xf4363804324a40aaull, // 5^265
+        0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull, // 5^266
+        0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull, // 5^267
+        0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull, // 5^268
+        0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull, // 5^269
+        0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull, // 5^270
+        0x976e41088617ca01ull, 0xd5be0503e085d813ull, // 5^271
+        0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull, // 5^272
+        0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull, // 5^273
+        0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull, // 5^274
+        0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull, // 5^275
+        0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull, // 5^276
+        0x906a617d450187e2ull, 0x27fb2b80668b24c5ull, // 5^277
+        0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull, // 5^278
+        0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull, // 5^279
+        0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull, // 5^280
+        0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull, // 5^281
+        0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull, // 5^282
+        0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull, // 5^283
+        0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull, // 5^284
+        0xd732290fbacaf133ull, 0xa97c177947ad4095ull, // 5^285
+        0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull, // 5^286
+        0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull, // 5^287
+        0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull, // 5^288
+        0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull, // 5^289
+        0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull, // 5^290
+        0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull, // 5^291
+        0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull, // 5^292
+        0xa0555e361951c366ull, 0xd7e105bcc332621full, // 5^293
+        0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull, // 5^294
+        0xfa856334878fc150ull, 0xb14f98f6f0feb951ull, // 5^295
+        0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull, // 5^296
+        0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull, // 5^297
+        0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull, // 5^298
+        0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull, // 5^299
+        0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull, // 5^300
+        0xeeea5d5004981478ull, 0x1858ccfce06cac74ull, // 5^301
+        0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull, // 5^302
+        0xbaa718e68396cffdull, 0xd30560258f54e6baull, // 5^303
+        0xe950df20247c83fdull, 0x47c6b82ef32a2069ull, // 5^304
+        0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull, // 5^305
+        0xb6472e511c81471dull, 0xe0133fe4adf8e952ull, // 5^306
+        0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull, // 5^307
+        0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull, // 5^308
+    };
+};
+
+//
+// Integer and float parsing without the C library (no locale, no errno), identical results with every toolchain.
+// Integer digits are converted 8 at a time with a SWAR kernel, floats use Eisel-Lemire with an exact fallback.
+// Same rules as std::from_chars (no leading '+', '-' only for signed types) but the whole string must be consumed.
+//
+class ArgNumberParser {
+public:
+    template<typename T>
+    static std::errc ParseInteger(const char *first, const char *last, T &out) {
+        static_assert(std::is_integral_v<T>, "ParseInteger: integral type required");
+        bool bNegative = false;
+        if constexpr (std::is_signed_v<T>) {
+            if ((first != last) && (*first == '-')) {
+                bNegative = true;
+                ++first;
+            }
         }
-        else if constexpr (std::is_same_v<T, std::string_view>) {
-            return sv;
+        if (first == last) {
+            return std::errc::invalid_argument;
         }
-        else if constexpr (std::is_same_v<T, bool>) {
-            if (sv == "1" || sv == "true"  || sv == "TRUE")  return true;
-            if (sv == "0" || sv == "false" || sv == "FALSE") return false;
-            return std::nullopt;
+
+        uint64_t value = 0;
+        bool bOverflow = false;
+        while((std::endian::native == std::endian::little) && ((last - first) >= 8)) {
+            uint64_t chunk;
+            memcpy(&chunk, first, sizeof(chunk));
+            if (!IsEightDigits(chunk)) break;
+            auto digits = ParseEightDigits(chunk);
+            if (value > (UINT64_MAX - digits) / 100000000ull) {
+                bOverflow = true;
+            }
+            value = value * 100000000ull + digits;
+            first += 8;
+        }
+        for(;first != last;++first) {
+            auto digit = static_cast<uint8_t>(*first - '0');
+            if (digit > 9) {
+                return std::errc::invalid_argument;
+            }
+            if (value > (UINT64_MAX - digit) / 10) {
+                bOverflow = true;
+            }
+            value = value * 10 + digit;
+        }
+        if (bOverflow) {
+            return std::errc::result_out_of_range;
         }
-        else if constexpr (std::is_arithmetic_v<T>) {
-            T out{};
-            auto first = sv.data();
-            auto last  = sv.data() + sv.size();
 
-            // This is only available on macos from 26.0 and onwards...
+        if constexpr (std::is_signed_v<T>) {
+            using TUnsigned = std::make_unsigned_t<T>;
+            auto maxMagnitude = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (bNegative ? 1 : 0);
+            if (value > maxMagnitude) {
+                return std::errc::result_out_of_range;
+            }
+            // two's complement negation in the unsigned domain, well defined for the minimum value as well
+            out = static_cast<T>(bNegative ? static_cast<TUnsigned>(0 - static_cast<TUnsigned>(value)) : static_cast<TUnsigned>(value));
+        } else {
+            if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                return std::errc::result_out_of_range;
+            }
+            out = static_cast<T>(value);
+        }
+        return {};
+    }
 
-            // std::from_chars handles all integers and floating point (C++17+)
-//            auto [ptr, ec] = std::from_chars(first, last, out);
-//            if (ec == std::errc{} && ptr == last)
-//                return out;
+    // Floating point parsing for float and double, same rules as std::from_chars in general format (no leading '+',
+    // case insensitive 'inf', 'infinity', 'nan' and 'nan(chars)') but the whole string must be consumed.
+    // Results are correctly rounded: Clinger's fast path for short exact values, Eisel-Lemire for the rest and an exact
+    // big integer comparison when more than 19 significant digits leave the rounding undecided.
+    template<typename T>
+    static std::errc ParseFloat(const char *first, const char *last, T &out) {
+        static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "ParseFloat: float or double required");
+        using Traits = FloatTraits<T>;
+        bool bNegative = false;
+        if ((first != last) && (*first == '-')) {
+            bNegative = true;
+            ++first;
+        }
+        if (first == last) {
+            return std::errc::invalid_argument;
+        }
+        if (!IsDigit(*first) && (*first != '.')) {
+            return ParseInfNan(first, last, bNegative, out);
+        }
 
-            auto ec = parse_number(first, last, out);
-            if (ec == std::errc{}) {
-                return out;
+        // value = mantissa * 10^exp10 from the first 19 significant digits, accumulated while scanning
+        uint64_t mantissa = 0;
+        int nSignificant = 0;
+        int64_t nDropped = 0;
+        bool bTruncated = false;
+        auto cbScanDigits = [&](const char *d) {
+            if (nSignificant == 0) {
+                while((d != last) && (*d == '0')) ++d;
+            }
+            while((std::endian::native == std::endian::little) && ((nSignificant + 8) <= kMaxMantissaDigits) && ((last - d) >= 8)) {
+                uint64_t chunk;
+                memcpy(&chunk, d, sizeof(chunk));
+                if (!IsEightDigits(chunk)) break;
+                mantissa = mantissa * 100000000ull + ParseEightDigits(chunk);
+                nSignificant += 8;
+                d += 8;
+            }
+            for(;(d != last) && IsDigit(*d); ++d) {
+                if (nSignificant < kMaxMantissaDigits) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*d - '0');
+                    nSignificant++;
+                } else {
+                    nDropped++;
+                    bTruncated |= (*d != '0');
+                }
             }
+            return d;
+        };
 
-            return std::nullopt;
+        FloatDigits digits;
+        digits.intFirst = first;
+        const char *p = digits.intLast = cbScanDigits(first);
+        digits.fracFirst = digits.fracLast = p;
+        if ((p != last) && (*p == '.')) {
+            digits.fracFirst = p + 1;
+            p = digits.fracLast = cbScanDigits(p + 1);
         }
-        else {
-            // Unsupported type; static assert provides helpful compile-time error
-            static_assert(!sizeof(T*), "convert_to<T>: Unsupported type");
+        if ((digits.intFirst == digits.intLast) && (digits.fracFirst == digits.fracLast)) {
+            return std::errc::invalid_argument;
+        }
+        if ((p != last) && ((*p == 'e') || (*p == 'E'))) {
+            ++p;
+            bool bNegativeExp = false;
+            if ((p != last) && ((*p == '-') || (*p == '+'))) {
+                bNegativeExp = (*p == '-');
+                ++p;
+            }
+            if ((p == last) || !IsDigit(*p)) {
+                return std::errc::invalid_argument;
+            }
+            for(;(p != last) && IsDigit(*p); ++p) {
+                // clamped, anything this large is zero or infinite anyway
+                if (digits.exponent < kMaxExponent) {
+                    digits.exponent = digits.exponent * 10 + (*p - '0');
+                }
+            }
+            if (bNegativeExp) {
+                digits.exponent = -digits.exponent;
+            }
+        }
+        if (p != last) {
+            return std::errc::invalid_argument;
+        }
+        int64_t exp10 = digits.exponent - (digits.fracLast - digits.fracFirst) + nDropped;
+
+        if (mantissa == 0) {
+            out = bNegative ? -T(0) : T(0);
+            return {};
+        }
+        if constexpr (kExactArithmetic) {
+            if (!bTruncated && (exp10 >= -Traits::kMaxExactPow10) && (exp10 <= Traits::kMaxExactPow10) && (mantissa <= Traits::kMaxExactMantissa)) {
+                auto value = static_cast<T>(mantissa);
+                value = (exp10 < 0) ? (value / Traits::kPow10[-exp10]) : (value * Traits::kPow10[exp10]);
+                out = bNegative ? -value : value;
+                return {};
+            }
+        }
+
+        auto am = ComputeFloat<T>(exp10, mantissa);
+        auto bits = ComposeBits<T>(am);
+        if (bTruncated) {
+            // the dropped digits lie between mantissa and mantissa + 1, done unless those two round differently
+            auto amUp = ComputeFloat<T>(exp10, mantissa + 1);
+            if ((amUp.mantissa != am.mantissa) || (amUp.power2 != am.power2)) {
+                auto cmp = CompareHalfway<T>(digits, am);
+                if ((cmp > 0) || ((cmp == 0) && ((bits & 1) != 0))) {
+                    bits++;
+                }
+            }
+        }
+
+        auto magnitude = static_cast<typename Traits::Bits>(bits);
+        constexpr auto infinity = static_cast<typename Traits::Bits>(uint64_t(Traits::kInfinitePower) << Traits::kMantissaBits);
+        if ((magnitude == 0) || (magnitude >= infinity)) {
+            return std::errc::result_out_of_range;
+        }
+        if (bNegative) {
+            magnitude |= static_cast<typename Traits::Bits>(uint64_t(1) << (sizeof(T) * 8 - 1));
         }
+        out = std::bit_cast<T>(magnitude);
+        return {};
     }
 
-    template<typename T>
-    std::errc parse_number(const char* first, const char* last, T& out) const {
-#if defined(__cpp_lib_to_chars)
-        // Use real from_chars
-        auto r = std::from_chars(first, last, out);
-        return r.ec;
+protected:
+    // True if all 8 bytes are '0'..'9'
+    static bool IsEightDigits(uint64_t chunk) {
+        return (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+    }
+    // Converts 8 ascii digits (little endian load, first digit in the lowest byte)
+    static uint64_t ParseEightDigits(uint64_t chunk) {
+        chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;
+        chunk = (chunk & 0x00FF00FF00FF00FFull) * 6553601 >> 16;
+        return (chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32;
+    }
+
+    static bool IsDigit(char ch) {
+        return static_cast<uint8_t>(ch - '0') <= 9;
+    }
+
+    static constexpr int64_t kMaxExponent = 0x10000;
+    static constexpr int kMaxMantissaDigits = 19;
+    // Clinger's fast path needs float arithmetic in the declared precision (not x87 extended precision)
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+    static constexpr bool kExactArithmetic = true;
 #else
-        // Fallback: use strtol / strtod depending on T
-        if constexpr (std::is_integral_v<T>) {
-            errno = 0;
-            char* end;
-            long long v = std::strtoll(first, &end, 10);
-            if (errno != 0 || end != last)
-                return std::errc::invalid_argument;
-            out = static_cast<T>(v);
+    static constexpr bool kExactArithmetic = false;
+#endif
+
+    // IEEE binary32/binary64 parameters for the Eisel-Lemire algorithm
+    template<typename T>
+    struct FloatTraits {
+        static constexpr bool bDouble = std::is_same_v<T, double>;
+        using Bits = std::conditional_t<bDouble, uint64_t, uint32_t>;
+        static constexpr int kMantissaBits = bDouble ? 52 : 23;
+        static constexpr int kMinimumExponent = bDouble ? -1023 : -127;
+        static constexpr int kInfinitePower = bDouble ? 0x7FF : 0xFF;
+        static constexpr int kMinRoundToEven = bDouble ? -4 : -17;
+        static constexpr int kMaxRoundToEven = bDouble ? 23 : 10;
+        static constexpr int kSmallestPow10 = bDouble ? -342 : -65;
+        static constexpr int kLargestPow10 = bDouble ? 308 : 38;
+        static constexpr int kMaxExactPow10 = bDouble ? 22 : 10;
+        static constexpr uint64_t kMaxExactMantissa = uint64_t(2) << kMantissaBits;
+        static constexpr T kPow10[] = {
+            T(1e0), T(1e1), T(1e2), T(1e3), T(1e4), T(1e5), T(1e6), T(1e7), T(1e8), T(1e9), T(1e10), T(1e11),
+            T(1e12), T(1e13), T(1e14), T(1e15), T(1e16), T(1e17), T(1e18), T(1e19), T(1e20), T(1e21), T(1e22)
+        };
+    };
+
+    // Digit ranges of a float literal, kept for the exact comparison in the slow path
+    struct FloatDigits {
+        const char *intFirst = nullptr;
+        const char *intLast = nullptr;
+        const char *fracFirst = nullptr;
+        const char *fracLast = nullptr;
+        int64_t exponent = 0;
+    };
+
+    // Binary result, mantissa without the hidden bit and a biased exponent
+    struct AdjustedMantissa {
+        uint64_t mantissa = 0;
+        int32_t power2 = 0;
+    };
+
+    template<typename T>
+    static std::errc ParseInfNan(const char *first, const char *last, bool bNegative, T &out) {
+        auto cbMatches = [first, last](std::string_view word) {
+            if (static_cast<size_t>(last - first) < word.size()) return false;
+            for(size_t i=0;i<word.size();i++) {
+                if ((first[i] | 0x20) != word[i]) return false;
+            }
+            return true;
+        };
+        auto length = static_cast<size_t>(last - first);
+        if (((length == 3) && cbMatches("inf")) || ((length == 8) && cbMatches("infinity"))) {
+            out = bNegative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
             return {};
-        } else if constexpr (std::is_floating_point_v<T>) {
-            errno = 0;
-            char* end;
-            double v = std::strtod(first, &end);
-            if (errno != 0 || end != last)
+        }
+        if (!cbMatches("nan")) {
+            return std::errc::invalid_argument;
+        }
+        if (length > 3) {
+            // 'nan(chars)' - letters, digits and '_'
+            if ((first[3] != '(') || (last[-1] != ')')) {
                 return std::errc::invalid_argument;
-            out = static_cast<T>(v);
-            return {};
+            }
+            for(auto p = first + 4; p != last - 1; ++p) {
+                if (!IsDigit(*p) && (((*p | 0x20) < 'a') || ((*p | 0x20) > 'z')) && (*p != '_')) {
+                    return std::errc::invalid_argument;
+                }
+            }
         }
+        out = bNegative ? -std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::quiet_NaN();
+        return {};
+    }
+
+    static void Multiply128(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo) {
+#if defined(__SIZEOF_INT128__)
+        // __extension__ keeps -Wpedantic quiet, __int128 is not ISO C++
+        __extension__ using uint128 = unsigned __int128;
+        auto product = static_cast<uint128>(a) * b;
+        hi = static_cast<uint64_t>(product >> 64);
+        lo = static_cast<uint64_t>(product);
+#else
+        uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+        uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+        uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+        uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+        hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+        lo = (mid << 32) | (ll & 0xFFFFFFFFu);
 #endif
     }
-private:
-    std::span<const char *> args;
-    std::string stoparg= {};
-    std::unordered_map<std::string, int> paramargs;
+
+    // floor(log2(10^q)) + 63
+    static int32_t Power(int32_t q) {
+        return (((152170 + 65536) * q) >> 16) + 63;
+    }
+
+    // w * 5^q to the precision needed, the second word of the power is only used when the first leaves it ambiguous
+    template<int kBitPrecision>
+    static void ProductApproximation(int64_t q, uint64_t w, uint64_t &hi, uint64_t &lo) {
+        auto index = 2 * static_cast<size_t>(q - ArgPowersOfFive::kSmallest);
+        Multiply128(w, ArgPowersOfFive::table[index], hi, lo);
+        constexpr uint64_t precisionMask = UINT64_MAX >> kBitPrecision;
+        if ((hi & precisionMask) == precisionMask) {
+            uint64_t secondHi, secondLo;
+            Multiply128(w, ArgPowersOfFive::table[index + 1], secondHi, secondLo);
+            lo += secondHi;
+            if (secondHi > lo) {
+                hi++;
+            }
+        }
+    }
+
+    // Eisel-Lemire: w * 10^q rounded to nearest even, w must be non-zero
+    template<typename T>
+    static AdjustedMantissa ComputeFloat(int64_t q, uint64_t w) {
+        using Traits = FloatTraits<T>;
+        AdjustedMantissa answer;
+        if (q < Traits::kSmallestPow10) {
+            return answer;
+        }
+        if (q > Traits::kLargestPow10) {
+            answer.power2 = Traits::kInfinitePower;
+            return answer;
+        }
+        auto lz = std::countl_zero(w);
+        w <<= lz;
+        uint64_t hi, lo;
+        ProductApproximation<Traits::kMantissaBits + 3>(q, w, hi, lo);
+        auto upperBit = static_cast<int32_t>(hi >> 63);
+        auto shift = upperBit + 64 - Traits::kMantissaBits - 3;
+        answer.mantissa = hi >> shift;
+        answer.power2 = Power(static_cast<int32_t>(q)) + upperBit - lz - Traits::kMinimumExponent;
+        if (answer.power2 <= 0) {
+            // subnormal, or zero when more than 64 bits below the smallest exponent
+            if ((-answer.power2 + 1) >= 64) {
+                answer.power2 = 0;
+                answer.mantissa = 0;
+                return answer;
+            }
+            answer.mantissa >>= -answer.power2 + 1;
+            answer.mantissa += (answer.mantissa & 1);
+            answer.mantissa >>= 1;
+            // rounding may carry into the smallest normal
+            answer.power2 = (answer.mantissa < (uint64_t(1) << Traits::kMantissaBits)) ? 0 : 1;
+            return answer;
+        }
+        // exactly halfway is only possible for small q, round to even there
+        if ((lo <= 1) && (q >= Traits::kMinRoundToEven) && (q <= Traits::kMaxRoundToEven) && ((answer.mantissa & 3) == 1)) {
+            if ((answer.mantissa << shift) == hi) {
+                answer.mantissa &= ~uint64_t(1);
+            }
+        }
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+        if (answer.mantissa >= (uint64_t(2) << Traits::kMantissaBits)) {
+            answer.mantissa = uint64_t(1) << Traits::kMantissaBits;
+            answer.power2++;
+        }
+        answer.mantissa &= ~(uint64_t(1) << Traits::kMantissaBits);
+        if (answer.power2 >= Traits::kInfinitePower) {
+            answer.power2 = Traits::kInfinitePower;
+            answer.mantissa = 0;
+        }
+        return answer;
+    }
+
+    template<typename T>
+    static uint64_t ComposeBits(const AdjustedMantissa &am) {
+        return am.mantissa | (static_cast<uint64_t>(am.power2) << FloatTraits<T>::kMantissaBits);
+    }
+
+    // Fixed capacity unsigned big integer, just enough for the halfway comparison
+    class FloatBigInt {
+    public:
+        void Assign(uint64_t value) {
+            limbs[0] = static_cast<uint32_t>(value);
+            limbs[1] = static_cast<uint32_t>(value >> 32);
+            nLimbs = (limbs[1] != 0) ? 2 : ((limbs[0] != 0) ? 1 : 0);
+        }
+        void MulAdd(uint32_t factor, uint32_t addend) {
+            uint64_t carry = addend;
+            for(size_t i=0;i<nLimbs;i++) {
+                auto product = static_cast<uint64_t>(limbs[i]) * factor + carry;
+                limbs[i] = static_cast<uint32_t>(product);
+                carry = product >> 32;
+            }
+            if ((carry != 0) && (nLimbs < kLimbs)) {
+                limbs[nLimbs++] = static_cast<uint32_t>(carry);
+            }
+        }
+        void MulPow5(int64_t exp5) {
+            // 5^13 is the largest power of five fitting 32 bits
+            for(;exp5 >= 13; exp5 -= 13) {
+                MulAdd(1220703125u, 0);
+            }
+            uint32_t factor = 1;
+            for(;exp5 > 0; exp5--) {
+                factor *= 5;
+            }
+            MulAdd(factor, 0);
+        }
+        void ShiftLeft(int64_t nBits) {
+            if ((nLimbs == 0) || (nBits <= 0)) return;
+            auto nWords = static_cast<size_t>(nBits / 32);
+            auto nRemaining = static_cast<uint32_t>(nBits % 32);
+            if ((nLimbs + nWords + 1) > kLimbs) return;
+            limbs[nLimbs] = 0;
+            for(size_t i=nLimbs+1;i-- > 0;) {
+                uint64_t wide = (static_cast<uint64_t>(limbs[i]) << 32) | ((i > 0) ? limbs[i-1] : 0);
+                limbs[i + nWords] = static_cast<uint32_t>(wide >> (32 - nRemaining));
+            }
+            std::fill_n(limbs.begin(), nWords, 0u);
+            nLimbs += nWords + 1;
+            while((nLimbs > 0) && (limbs[nLimbs - 1] == 0)) nLimbs--;
+        }
+        static int Compare(const FloatBigInt &a, const FloatBigInt &b) {
+            if (a.nLimbs != b.nLimbs) return (a.nLimbs < b.nLimbs) ? -1 : 1;
+            for(size_t i=a.nLimbs;i-- > 0;) {
+                if (a.limbs[i] != b.limbs[i]) return (a.limbs[i] < b.limbs[i]) ? -1 : 1;
+            }
+            return 0;
+        }
+    private:
+        // 6144 bits, the largest comparison needs a little less than 4000
+        static constexpr size_t kLimbs = 192;
+        std::array<uint32_t, kLimbs> limbs = {};
+        size_t nLimbs = 0;
+    };
+
+    // Compares the decimal value against the halfway point between am and its successor: -1 below, 0 equal, 1 above
+    template<typename T>
+    static int CompareHalfway(const FloatDigits &digits, const AdjustedMantissa &am) {
+        using Traits = FloatTraits<T>;
+        // digits beyond this can only decide a tie, they are folded into a sticky '1'
+        constexpr int64_t kMaxDigits = 780;
+
+        FloatBigInt decimal;
+        int64_t nDigits = 0;
+        int64_t nDropped = 0;
+        bool bSticky = false;
+        uint32_t chunk = 0, chunkScale = 1;
+        auto cbDigits = [&](const char *d, const char *dLast) {
+            if (nDigits == 0) {
+                while((d != dLast) && (*d == '0')) ++d;
+            }
+            for(;d != dLast; ++d) {
+                if (nDigits >= kMaxDigits) {
+                    nDropped++;
+                    bSticky |= (*d != '0');
+                    continue;
+                }
+                chunk = chunk * 10 + static_cast<uint32_t>(*d - '0');
+                chunkScale *= 10;
+                nDigits++;
+                if (chunkScale == 1000000000u) {
+                    decimal.MulAdd(chunkScale, chunk);
+                    chunk = 0;
+                    chunkScale = 1;
+                }
+            }
+        };
+        cbDigits(digits.intFirst, digits.intLast);
+        cbDigits(digits.fracFirst, digits.fracLast);
+        int64_t exp10 = digits.exponent - (digits.fracLast - digits.fracFirst) + nDropped;
+        if (bSticky) {
+            chunk = chunk * 10 + 1;
+            chunkScale *= 10;
+            exp10--;
+        }
+        decimal.MulAdd(chunkScale, chunk);
+
+        // halfway = (2m + 1) * 2^(e - 1)
+        auto m = am.mantissa;
+        int64_t e = Traits::kMinimumExponent + 1 - Traits::kMantissaBits;
+        if (am.power2 > 0) {
+            m |= uint64_t(1) << Traits::kMantissaBits;
+            e = am.power2 + Traits::kMinimumExponent - Traits::kMantissaBits;
+        }
+        FloatBigInt halfway;
+        halfway.Assign(2 * m + 1);
+
+        // D * 10^exp10 <=> H * 2^(e - 1), with 10^exp10 = 5^exp10 * 2^exp10
+        if (exp10 >= 0) {
+            decimal.MulPow5(exp10);
+        } else {
+            halfway.MulPow5(-exp10);
+        }
+        auto exp2 = exp10 - (e - 1);
+        if (exp2 >= 0) {
+            decimal.ShiftLeft(exp2);
+        } else {
+            halfway.ShiftLeft(-exp2);
+        }
+        return FloatBigInt::Compare(decimal, halfway);
+    }
+};
+
+//
+// Converter customization point, resolved at compile time. Specialize for your own types:
+//
+//      template<> struct ArgConverter<Endpoint> {
+//          static std::optional<Endpoint> Convert(std::string_view sv) { ... }
+//      };
+//
+// or declare 'bool ArgFromString(std::string_view sv, Endpoint &out)' next to the type (found by ADL).
+// Every query taking values (TryParse, vectors, lists, Values, ArgSchema, ArgBinder) picks it up.
+// Built in: byte sizes (ArgByteSize), std::chrono durations and enums (named through ArgEnumNames).
+//
+template<typename T>
+struct ArgConverter {};
+
+template<typename T>
+concept ArgHasConverter = requires(std::string_view sv) {
+    { ArgConverter<T>::Convert(sv) } -> std::same_as<std::optional<T>>;
+};
+
+template<typename T>
+concept ArgHasFromString = requires(std::string_view sv, T &out) {
+    { ArgFromString(sv, out) } -> std::same_as<bool>;
+};
+
+//
+// Names for an enum, without it the enum is parsed from its underlying integer value:
+//
+//      template<> struct ArgEnumNames<Color> {
+//          static constexpr std::pair<std::string_view, Color> names[] = {{"red", Color::Red}, {"green", Color::Green}};
+//      };
+//
+template<typename E>
+struct ArgEnumNames {};
+
+template<typename E>
+concept ArgHasEnumNames = requires {
+    { std::size(ArgEnumNames<E>::names) };
+};
+
+template<typename E> requires std::is_enum_v<E>
+struct ArgConverter<E> {
+    static std::optional<E> Convert(std::string_view sv) {
+        if constexpr (ArgHasEnumNames<E>) {
+            for(auto &[name, value] : ArgEnumNames<E>::names) {
+                if (name == sv) {
+                    return value;
+                }
+            }
+            return std::nullopt;
+        } else {
+            std::underlying_type_t<E> value;
+            if (ArgNumberParser::ParseInteger(sv.data(), sv.data() + sv.size(), value) != std::errc{}) {
+                return std::nullopt;
+            }
+            return static_cast<E>(value);
+        }
+    }
+};
+
+//
+// Byte size with an optional binary suffix, case insensitive: '512', '4K', '64KiB', '1G', '2TB' (K = 1024)
+//
+struct ArgByteSize {
+    uint64_t bytes = 0;
+
+    constexpr operator uint64_t() const { return bytes; }
+    auto operator<=>(const ArgByteSize &other) const = default;
+};
+
+template<>
+struct ArgConverter<ArgByteSize> {
+    static std::optional<ArgByteSize> Convert(std::string_view sv) {
+        auto idxSuffix = sv.find_first_not_of("0123456789");
+        auto digits = sv.substr(0, idxSuffix);
+        auto suffix = (idxSuffix == std::string_view::npos) ? std::string_view{} : sv.substr(idxSuffix);
+
+        uint64_t value;
+        if (ArgNumberParser::ParseInteger(digits.data(), digits.data() + digits.size(), value) != std::errc{}) {
+            return std::nullopt;
+        }
+        int shift = 0;
+        if (!suffix.empty()) {
+            static constexpr std::string_view units = "kmgtpe";
+            auto idxUnit = units.find(static_cast<char>(suffix[0] | 0x20));
+            if (idxUnit != std::string_view::npos) {
+                shift = 10 * static_cast<int>(idxUnit + 1);
+                suffix.remove_prefix(1);
+                if (!suffix.empty() && ((suffix[0] | 0x20) == 'i')) {
+                    suffix.remove_prefix(1);
+                    if (suffix.empty()) {
+                        return std::nullopt;
+                    }
+                }
+            }
+            if (!suffix.empty() && (((suffix[0] | 0x20) != 'b') || (suffix.size() != 1))) {
+                return std::nullopt;
+            }
+        }
+        if ((shift != 0) && (value > (UINT64_MAX >> shift))) {
+            return std::nullopt;
+        }
+        return ArgByteSize{value << shift};
+    }
+};
+
+//
+// std::chrono durations, integer amounts with a unit which can be combined: '250ms', '10s', '1h30m', '2d'
+// Units are ns, us, ms, s, m (or min), h and d; a bare number is taken in the duration's own unit.
+// For integral durations the value must be exact, '1500ms' is rejected for std::chrono::seconds.
+//
+template<typename Rep, typename Period>
+struct ArgConverter<std::chrono::duration<Rep, Period>> {
+    using TDuration = std::chrono::duration<Rep, Period>;
+
+    static std::optional<TDuration> Convert(std::string_view sv) {
+        bool bNegative = false;
+        if (!sv.empty() && (sv[0] == '-')) {
+            bNegative = true;
+            sv.remove_prefix(1);
+        }
+        if (sv.empty()) {
+            return std::nullopt;
+        }
+        if (sv.find_first_not_of("0123456789") == std::string_view::npos) {
+            int64_t count;
+            if (ArgNumberParser::ParseInteger(sv.data(), sv.data() + sv.size(), count) != std::errc{}) {
+                return std::nullopt;
+            }
+            return TDuration(static_cast<Rep>(bNegative ? -count : count));
+        }
+
+        int64_t totalNs = 0;
+        while(!sv.empty()) {
+            auto idxUnit = sv.find_first_not_of("0123456789");
+            if ((idxUnit == 0) || (idxUnit == std::string_view::npos)) {
+                return std::nullopt;
+            }
+            int64_t count;
+            if (ArgNumberParser::ParseInteger(sv.data(), sv.data() + idxUnit, count) != std::errc{}) {
+                return std::nullopt;
+            }
+            sv.remove_prefix(idxUnit);
+            auto idxNext = sv.find_first_of("0123456789");
+            auto unitNs = UnitToNs(sv.substr(0, idxNext));
+            if ((unitNs == 0) || (count > (INT64_MAX - totalNs) / unitNs)) {
+                return std::nullopt;
+            }
+            totalNs += count * unitNs;
+            sv.remove_prefix((idxNext == std::string_view::npos) ? sv.size() : idxNext);
+        }
+
+        auto ns = std::chrono::nanoseconds(bNegative ? -totalNs : totalNs);
+        if constexpr (std::is_floating_point_v<Rep>) {
+            return std::chrono::duration_cast<TDuration>(ns);
+        } else {
+            auto value = std::chrono::duration_cast<TDuration>(ns);
+            if (std::chrono::duration_cast<std::chrono::nanoseconds>(value) != ns) {
+                return std::nullopt;
+            }
+            return value;
+        }
+    }
+protected:
+    static int64_t UnitToNs(std::string_view unit) {
+        if (unit == "ns") return 1;
+        if (unit == "us") return 1000;
+        if (unit == "ms") return 1000000;
+        if (unit == "s") return 1000000000;
+        if ((unit == "m") || (unit == "min")) return 60ll * 1000000000;
+        if (unit == "h") return 3600ll * 1000000000;
+        if (unit == "d") return 86400ll * 1000000000;
+        return 0;
+    }
+};
+
+class ArgSnapshot;
+template<size_t MaxOptions, size_t MaxArgs> class StaticArgParser;
+template<size_t N> struct ArgName;
+template<ArgName... Names> class ArgSubcommands;
+
+//
+// Types and stateless helpers shared by ArgParser and StaticArgParser
+//
+class ArgParserBase {
+    friend class ArgParser;
+    template<size_t MaxOptions, size_t MaxArgs> friend class StaticArgParser;
+public:
+    enum class kParseResult {
+        Ok,
+        OkNotPresent,
+        ErrMissingArg,
+        ErrArgTypeError,
+    };
+
+    // What went wrong, all views point into argv (or the queried name when the option is missing altogether)
+    struct ArgError {
+        // 'idxArg' of a value taken from the environment or the config file, 'option' is the variable name or the
+        // config key then
+        static constexpr size_t kEnvironment = SIZE_MAX;
+        static constexpr size_t kConfig = SIZE_MAX - 1;
+
+        kParseResult kind = kParseResult::Ok;
+        // argv index of the offending argument, the option for a missing value and the value for a conversion error
+        size_t idxArg = 0;
+        std::string_view option = {};
+    };
+
+    // Pluggable diagnostics sink, called for every parse error. A plain function pointer and a context, so reporting
+    // never allocates and nothing is written anywhere unless a sink is set. 'Stderr' restores the classic messages.
+    struct ArgDiagnostics {
+        using Callback = void (*)(void *context, const ArgError &error);
+        Callback cbReport = nullptr;
+        void *context = nullptr;
+
+        static void Stderr(void *, const ArgError &error) {
+            auto what = (error.kind == kParseResult::ErrMissingArg) ? "Argument missing for" : "Invalid value for";
+            if ((error.idxArg == ArgError::kEnvironment) || (error.idxArg == ArgError::kConfig)) {
+                auto source = (error.idxArg == ArgError::kEnvironment) ? "environment" : "config";
+                fprintf(stderr, "%s '%.*s' (%s)\n", what, (int)error.option.size(), error.option.data(), source);
+                return;
+            }
+            fprintf(stderr, "%s '%.*s' (argv[%zu])\n", what, (int)error.option.size(), error.option.data(), error.idxArg);
+        }
+    };
+
+    // Thrown by ArgResult::value() on an error, carries the error - like std::bad_expected_access
+    class ArgBadResultAccess : public std::exception {
+    public:
+        explicit ArgBadResultAccess(const ArgError &error) : err(error) {
+        }
+        [[nodiscard]]
+        const char *what() const noexcept override {
+            return "ArgResult: access to the value of an error result";
+        }
+        [[nodiscard]]
+        const ArgError &error() const noexcept {
+            return err;
+        }
+    private:
+        ArgError err;
+    };
+
+    // Value or error, the same interface as std::expected<TValue, ArgError> (C++23) so it can be swapped for it later
+    template<typename TValue>
+    class ArgResult {
+    public:
+        ArgResult(const TValue &value) : val(value) {
+        }
+        ArgResult(TValue &&value) : val(std::move(value)) {
+        }
+        ArgResult(const ArgError &error) : err(error) {
+        }
+
+        [[nodiscard]]
+        bool has_value() const {
+            return val.has_value();
+        }
+        explicit operator bool() const {
+            return val.has_value();
+        }
+        TValue &value() {
+            if (!val.has_value()) {
+                throw ArgBadResultAccess(err);
+            }
+            return *val;
+        }
+        const TValue &value() const {
+            if (!val.has_value()) {
+                throw ArgBadResultAccess(err);
+            }
+            return *val;
+        }
+        TValue &operator*() {
+            return *val;
+        }
+        const TValue &operator*() const {
+            return *val;
+        }
+        TValue *operator->() {
+            return &*val;
+        }
+        const TValue *operator->() const {
+            return &*val;
+        }
+        template<typename U>
+        TValue value_or(U &&defaultValue) const {
+            return val.value_or(std::forward<U>(defaultValue));
+        }
+        // Only valid without a value
+        [[nodiscard]]
+        const ArgError &error() const {
+            return err;
+        }
+    private:
+        std::optional<TValue> val = {};
+        ArgError err = {};
+    };
+protected:
+    // A matched option and where its value is. The value is either the next argument or attached to the option
+    // itself ('--name=value', '-nVALUE'), in both cases a slice of argv.
+    struct ArgMatch {
+        size_t idxOption = 0;
+        bool bAttached = false;
+        std::string_view value = {};
+        // argv index of the value being converted, advanced by converters taking several values
+        size_t idxValue = 0;
+
+        // Index of the first argument after the value
+        [[nodiscard]]
+        size_t IndexAfterValue() const {
+            return idxOption + (bAttached ? 1 : 2);
+        }
+    };
+
+    enum class kMatch {
+        None,
+        Exact,          // '-a' or '--name'
+        Attached,       // '--name=value' or '-nVALUE'
+        Bundled,        // a letter in a list of short names, like '-b' in '-abc'
+    };
+
+    // How an argument matches the option, the value of an attached form is a slice of the argument
+    static kMatch MatchOption(std::string_view arg, bool bHaveParam, std::string_view shortParamName, std::string_view longParamName, std::string_view &outAttached) {
+        // simple check if we have a single parameter ('-a' or '--name') with/without arguments
+        if ((arg == shortParamName) || (arg == longParamName)) {
+            return kMatch::Exact;
+        }
+        if (!longParamName.empty() && (arg.length() > longParamName.length()) && (arg[longParamName.length()] == '=') && arg.starts_with(longParamName)) {
+            outAttached = arg.substr(longParamName.length() + 1);
+            return kMatch::Attached;
+        }
+
+        // this is a long name - we do NOT check them for presence of short paramnames (used for flags)
+        if (arg.starts_with("--")) {
+            return kMatch::None;
+        }
+
+        // a value directly after a short name, only for options with values - for flags this is a bundle
+        if (bHaveParam && (shortParamName.length() > 1) && !shortParamName.starts_with("--") && (arg.length() > shortParamName.length()) && arg.starts_with(shortParamName)) {
+            outAttached = arg.substr(shortParamName.length());
+            return kMatch::Attached;
+        }
+
+        //
+        // check if the parameter is embedded in a list of parameters (like '-b' in '-abc')
+        // Note: We DO NOT allow arguments here, by design... the value is the next argument
+        //
+        for(size_t j=1;j<arg.length();j++) {
+            if (shortParamName.find(arg[j]) != std::string_view::npos) {
+                return kMatch::Bundled;
+            }
+        }
+        return kMatch::None;
+    }
+
+    static bool IsEqual(const char *arg, std::string_view name) {
+        if (name.empty()) {
+            return arg[0] == '\0';
+        }
+        return (std::strncmp(arg, name.data(), name.size()) == 0) && (arg[name.size()] == '\0');
+    }
+    static bool IsValidArgument(const std::string_view &arg) {
+        if (arg.empty() || arg[0] != '-') {
+            return false;
+        }
+        return true;
+    }
+
+    static kParseResult Report(const ArgDiagnostics &diagnostics, const ArgError &error, ArgError *pError) {
+        if (pError != nullptr) {
+            *pError = error;
+        }
+        if (diagnostics.cbReport != nullptr) {
+            diagnostics.cbReport(diagnostics.context, error);
+        }
+        return error.kind;
+    }
+
+    static ArgError MakeError(std::span<const char *> args, kParseResult kind, size_t idxOption, size_t idxArg, std::string_view shortParamName) {
+        ArgError error{kind, idxArg, {}};
+        // the option as written on the command line, for attached values without the value
+        std::string_view arg = args[idxOption];
+        if (arg.starts_with("--")) {
+            error.option = OptionName(arg);
+        } else {
+            error.option = (!shortParamName.empty() && arg.starts_with(shortParamName)) ? arg.substr(0, shortParamName.length()) : arg;
+        }
+        return error;
+    }
+
+    // Name part of a long argument with an attached value, '--name=value' -> '--name'
+    static std::string_view OptionName(std::string_view arg) {
+        if (arg.starts_with("--")) {
+            auto idxSeparator = arg.find('=');
+            if (idxSeparator != std::string_view::npos) {
+                return arg.substr(0, idxSeparator);
+            }
+        }
+        return arg;
+    }
+
+    //
+    // Index over argv, built in a single pass up to the stop condition.
+    //  - every valid argument ('-a', '-abc', '--name') goes into an open addressing table with first index and count
+    //  - every letter of a short argument (or bundle) gets a first index and a count
+    // The table refers to argv by index, no strings are copied.
+    //
+    struct ArgIndex {
+        static constexpr size_t npos = SIZE_MAX;
+        static constexpr uint32_t kEmpty = UINT32_MAX;
+
+        struct Slot {
+            uint32_t idxFirst = kEmpty;
+            uint32_t count = 0;
+        };
+
+        void Build(std::span<const char *> args, std::string_view stopArg) {
+            slots.assign(TableSize(args.size()), {});
+            shortFirst.fill(kEmpty);
+            for(size_t i=0;i<args.size();++i) {
+                std::string_view arg = args[i];
+                if (arg == stopArg) {
+                    break;
+                }
+                if (!IsValidArgument(arg)) {
+                    continue;
+                }
+                // '--name=value' is stored under '--name'
+                auto &slot = Probe(args, OptionName(arg));
+                if (slot.idxFirst == kEmpty) {
+                    slot.idxFirst = static_cast<uint32_t>(i);
+                }
+                slot.count++;
+
+                if (arg.starts_with("--")) continue;
+                for(size_t j=1;j<arg.length();j++) {
+                    auto ch = static_cast<uint8_t>(arg[j]);
+                    if (shortFirst[ch] == kEmpty) {
+                        shortFirst[ch] = static_cast<uint32_t>(i);
+                    }
+                }
+            }
+            bValid = true;
+        }
+
+        // Index of the first argument matching either name exactly or, for short arguments, containing a letter of the short name
+        [[nodiscard]]
+        size_t FirstMatch(std::span<const char *> args, std::string_view shortParamName, std::string_view longParamName) const {
+            uint32_t idx = kEmpty;
+            if (!shortParamName.empty()) {
+                idx = std::min(idx, Find(args, shortParamName).idxFirst);
+                for(auto ch : shortParamName) {
+                    idx = std::min(idx, shortFirst[static_cast<uint8_t>(ch)]);
+                }
+            }
+            if (!longParamName.empty()) {
+                idx = std::min(idx, Find(args, longParamName).idxFirst);
+            }
+            return (idx == kEmpty) ? npos : idx;
+        }
+
+        // Number of arguments equal to 'name'
+        [[nodiscard]]
+        int CountExact(std::span<const char *> args, std::string_view name) const {
+            if (name.empty()) {
+                return 0;
+            }
+            return static_cast<int>(Find(args, name).count);
+        }
+
+        // Index of the first short argument or bundle containing the letter
+        [[nodiscard]]
+        size_t FirstWithLetter(char ch) const {
+            auto idx = shortFirst[static_cast<uint8_t>(ch)];
+            return (idx == kEmpty) ? npos : idx;
+        }
+
+        // Index of the first argument equal to 'name'
+        [[nodiscard]]
+        size_t FirstExact(std::span<const char *> args, std::string_view name) const {
+            if (name.empty()) {
+                return npos;
+            }
+            auto idx = Find(args, name).idxFirst;
+            return (idx == kEmpty) ? npos : idx;
+        }
+
+        bool bValid = false;
+    private:
+        static size_t TableSize(size_t nArgs) {
+            // power of two, at most 50% load
+            size_t n = 16;
+            while(n < nArgs * 2) n <<= 1;
+            return n;
+        }
+
+        // linear probing, the slot either holds 'name' or is the empty slot where it should go
+        [[nodiscard]]
+        size_t ProbePos(std::span<const char *> args, std::string_view name) const {
+            size_t mask = slots.size() - 1;
+            size_t pos = std::hash<std::string_view>{}(name) & mask;
+            while((slots[pos].idxFirst != kEmpty) && (OptionName(args[slots[pos].idxFirst]) != name)) {
+                pos = (pos + 1) & mask;
+            }
+            return pos;
+        }
+        Slot &Probe(std::span<const char *> args, std::string_view name) {
+            return slots[ProbePos(args, name)];
+        }
+        [[nodiscard]]
+        const Slot &Find(std::span<const char *> args, std::string_view name) const {
+            return slots[ProbePos(args, name)];
+        }
+
+        std::vector<Slot> slots;
+        std::array<uint32_t, 256> shortFirst = {};
+    };
+
+    //
+    // Letters of all short arguments and bundles ('-v', '-abc') reduced to a presence bitset and a count per letter.
+    // Built in a single pass on the first short name query, after that short name queries are bit and counter lookups.
+    //
+    struct ArgShortFlags {
+        void Build(std::span<const char *> args, std::string_view stopArg) {
+            present.reset();
+            counts.fill(0);
+            for(size_t i=0;i<args.size();++i) {
+                std::string_view arg = args[i];
+                if (arg == stopArg) {
+                    break;
+                }
+                if (!IsValidArgument(arg) || arg.starts_with("--")) {
+                    continue;
+                }
+                for(size_t j=1;j<arg.length();j++) {
+                    auto ch = static_cast<uint8_t>(arg[j]);
+                    present.set(ch);
+                    counts[ch]++;
+                }
+            }
+            bValid = true;
+        }
+
+        // Any letter of the name present in any short argument
+        [[nodiscard]]
+        bool AnyPresent(std::string_view name) const {
+            for(auto ch : name) {
+                if (present.test(static_cast<uint8_t>(ch))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Same semantics as the linear scan in CountPresence
+        [[nodiscard]]
+        int Count(std::string_view name) const {
+            int nFound = 0;
+            for(size_t i=0;i<name.length();i++) {
+                // only count each letter once, regardless of how many times it occurs in the name
+                if (name.find(name[i]) != i) continue;
+                nFound += static_cast<int>(counts[static_cast<uint8_t>(name[i])]);
+            }
+            return nFound;
+        }
+
+        std::bitset<256> present;
+        std::array<uint32_t, 256> counts = {};
+        bool bValid = false;
+    };
+
+    // Convert a single value in place, integers take the 8 digits at a time path
+    template<typename TValue>
+    static bool ConvertElement(std::string_view element, TValue &outValue) {
+        if constexpr (std::is_integral_v<TValue> && !std::is_same_v<TValue, bool> && !ArgHasConverter<TValue>) {
+            return ArgNumberParser::ParseInteger(element.data(), element.data() + element.size(), outValue) == std::errc{};
+        } else {
+            auto v = convert_to<TValue>(element);
+            if (!v.has_value()) {
+                return false;
+            }
+            outValue = std::move(*v);
+            return true;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    static std::optional<T> convert_to(std::string_view sv) {
+        //T value;
+
+        if constexpr (ArgHasConverter<T>) {
+            return ArgConverter<T>::Convert(sv);
+        }
+        else if constexpr (ArgHasFromString<T>) {
+            T out{};
+            if (!ArgFromString(sv, out)) {
+                return std::nullopt;
+            }
+            return out;
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string{sv};
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>) {
+            return sv;
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            if (sv == "1" || sv == "true"  || sv == "TRUE")  return true;
+            if (sv == "0" || sv == "false" || sv == "FALSE") return false;
+            return std::nullopt;
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            T out{};
+            auto first = sv.data();
+            auto last  = sv.data() + sv.size();
+
+            // This is only available on macos from 26.0 and onwards...
+
+            // std::from_chars handles all integers and floating point (C++17+)
+//            auto [ptr, ec] = std::from_chars(first, last, out);
+//            if (ec == std::errc{} && ptr == last)
+//                return out;
+
+            auto ec = parse_number(first, last, out);
+            if (ec == std::errc{}) {
+                return out;
+            }
+
+            return std::nullopt;
+        }
+        else {
+            // Unsupported type; static assert provides helpful compile-time error
+            static_assert(!sizeof(T*), "convert_to<T>: Unsupported type, specialize ArgConverter<T> or provide ArgFromString");
+        }
+    }
+
+    template<typename T>
+    static std::errc parse_number(const char* first, const char* last, T& out) {
+        // integers, float and double never touch the C library - same result with every toolchain and locale
+        if constexpr (std::is_integral_v<T>) {
+            return ArgNumberParser::ParseInteger(first, last, out);
+        } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            return ArgNumberParser::ParseFloat(first, last, out);
+        } else {
+#if defined(__cpp_lib_to_chars)
+            auto r = std::from_chars(first, last, out);
+            if ((r.ec == std::errc{}) && (r.ptr != last)) {
+                return std::errc::invalid_argument;
+            }
+            return r.ec;
+#else
+            // long double only
+            errno = 0;
+            char* end;
+            auto v = std::strtold(first, &end);
+            if (errno != 0 || end != last)
+                return std::errc::invalid_argument;
+            out = static_cast<T>(v);
+            return {};
+#endif
+        }
+    }
+
+    // Where ParseValues and ParseList put the values, a growing vector or caller provided storage
+    template<typename TValue>
+    struct ArgVectorStore {
+        void Reserve(size_t nValues) {
+            values.reserve(values.size() + nValues);
+        }
+        bool Store(TValue &&value) {
+            values.push_back(std::move(value));
+            return true;
+        }
+        std::vector<TValue> &values;
+    };
+
+    template<typename TValue, size_t Extent>
+    struct ArgSpanStore {
+        bool Store(TValue &&value) {
+            if (nStored >= values.size()) {
+                return false;
+            }
+            values[nStored++] = std::move(value);
+            return true;
+        }
+        std::span<TValue, Extent> values;
+        size_t nStored = 0;
+    };
+
+    // True if one of the first 'nFlags' consumed flags is 'name'. Flag 'i' is the text from 'ends[i-1]' to 'ends[i]',
+    // the hashes are searched and the name decides on a hit - names with the same hash don't consume each other.
+    static bool FindConsumedFlag(const size_t *hashes, const size_t *ends, const char *text, size_t nFlags, size_t hash, std::string_view name) {
+        for(auto it = hashes; (it = std::find(it, hashes + nFlags, hash)) != (hashes + nFlags); ++it) {
+            auto idx = static_cast<size_t>(it - hashes);
+            size_t start = (idx == 0) ? 0 : ends[idx - 1];
+            if (std::string_view(text + start, ends[idx] - start) == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Long names of consumed flags, copied into the object - the name given to a query may be a temporary
+    template<size_t MaxFlags, size_t MaxText>
+    struct ArgFlagNames {
+        // False once out of slots or text
+        bool Add(std::string_view name, size_t hash) {
+            if ((nFlags >= MaxFlags) || (name.size() > (MaxText - szText))) {
+                return false;
+            }
+            memcpy(text.data() + szText, name.data(), name.size());
+            szText += name.size();
+            hashes[nFlags] = hash;
+            ends[nFlags++] = szText;
+            return true;
+        }
+
+        [[nodiscard]]
+        bool Has(std::string_view name, size_t hash) const {
+            return FindConsumedFlag(hashes.data(), ends.data(), text.data(), nFlags, hash, name);
+        }
+
+        void Clear() {
+            nFlags = 0;
+            szText = 0;
+        }
+
+        std::array<size_t, MaxFlags> hashes = {};
+        std::array<size_t, MaxFlags> ends = {};
+        std::array<char, MaxText> text = {};
+        size_t nFlags = 0;
+        size_t szText = 0;
+    };
+
+    // Grows with argv, the stop argument is copied and an index can be built on top. Up to 'kInlineArgs' arguments and
+    // the first 'kInlineFlags' flag names (up to 'kInlineFlagText' bytes) are kept in the object. A longer argv gets
+    // its bitmap on construction or Reset, so queries don't allocate, and the flag lists are allocated on the first
+    // flag which doesn't fit.
+    struct ArgDynamicStorage {
+        static constexpr bool kIndexed = true;
+        static constexpr size_t kInlineArgs = 64;
+        static constexpr size_t kInlineFlags = 8;
+        static constexpr size_t kInlineFlagText = 256;
+        // flags queried beyond the inline ones before the lists need to grow
+        static constexpr size_t kConsumedFlagsCapacity = 32;
+
+        // Allocated capacity is kept
+        void ResetConsumed(size_t nArgs) {
+            consumedInline = 0;
+            consumed.clear();
+            if (nArgs > kInlineArgs) {
+                consumed.resize((nArgs + 63) / 64, 0);
+            }
+            inlineFlags.Clear();
+            consumedFlags.clear();
+            consumedFlagEnds.clear();
+            consumedFlagText.clear();
+        }
+
+        void SetConsumed(size_t idx, size_t nArgs) {
+            if (nArgs <= kInlineArgs) {
+                consumedInline |= uint64_t(1) << idx;
+                return;
+            }
+            consumed[idx >> 6] |= uint64_t(1) << (idx & 63);
+        }
+
+        [[nodiscard]]
+        bool TestConsumed(size_t idx) const {
+            if (consumed.empty()) {
+                return (idx < kInlineArgs) && (((consumedInline >> idx) & 1) != 0);
+            }
+            return ((consumed[idx >> 6] >> (idx & 63)) & 1) != 0;
+        }
+
+        // Never full
+        bool AddConsumedFlag(std::string_view name) {
+            auto hash = std::hash<std::string_view>{}(name);
+            if (inlineFlags.Add(name, hash)) {
+                return true;
+            }
+            if (consumedFlags.capacity() == 0) {
+                consumedFlags.reserve(kConsumedFlagsCapacity);
+                consumedFlagEnds.reserve(kConsumedFlagsCapacity);
+                consumedFlagText.reserve(kInlineFlagText);
+            }
+            consumedFlagText.append(name);
+            consumedFlags.push_back(hash);
+            consumedFlagEnds.push_back(consumedFlagText.size());
+            return true;
+        }
+
+        [[nodiscard]]
+        bool HasConsumedFlag(std::string_view name) const {
+            if ((inlineFlags.nFlags == 0) && consumedFlags.empty()) {
+                return false;
+            }
+            auto hash = std::hash<std::string_view>{}(name);
+            return inlineFlags.Has(name, hash) ||
+                   FindConsumedFlag(consumedFlags.data(), consumedFlagEnds.data(), consumedFlagText.data(), consumedFlags.size(), hash, name);
+        }
+
+        std::string stoparg = {};
+        uint64_t consumedInline = 0;
+        std::vector<uint64_t> consumed;
+        ArgFlagNames<kInlineFlags, kInlineFlagText> inlineFlags;
+        std::vector<size_t> consumedFlags;
+        std::vector<size_t> consumedFlagEnds;
+        std::string consumedFlagText;
+        ArgIndex argIndex;
+    };
+
+    // Everything in the object, 'MaxArgs' bits and 'MaxOptions' flag names of 'kFlagNameSize' bytes on average - the
+    // stop argument is referenced, not copied
+    template<size_t MaxOptions, size_t MaxArgs>
+    struct ArgFixedStorage {
+        static constexpr bool kIndexed = false;
+        static constexpr size_t kFlagNameSize = 32;
+
+        void ResetConsumed(size_t) {
+            consumed = {};
+            consumedFlags.Clear();
+        }
+
+        void SetConsumed(size_t idx, size_t) {
+            consumed[idx >> 6] |= uint64_t(1) << (idx & 63);
+        }
+
+        [[nodiscard]]
+        bool TestConsumed(size_t idx) const {
+            return ((consumed[idx >> 6] >> (idx & 63)) & 1) != 0;
+        }
+
+        // False once out of slots or text
+        bool AddConsumedFlag(std::string_view name) {
+            return consumedFlags.Add(name, std::hash<std::string_view>{}(name));
+        }
+
+        [[nodiscard]]
+        bool HasConsumedFlag(std::string_view name) const {
+            if (consumedFlags.nFlags == 0) {
+                return false;
+            }
+            return consumedFlags.Has(name, std::hash<std::string_view>{}(name));
+        }
+
+        std::string_view stoparg = {};
+        std::array<uint64_t, (MaxArgs + 63) / 64> consumed = {};
+        ArgFlagNames<MaxOptions, MaxOptions * kFlagNameSize> consumedFlags;
+    };
+};
+
+//
+// Scanning argv and keeping track of what has been consumed, the part of the parser shared by ArgParser and
+// StaticArgParser. 'TStorage' is one of the storage types above.
+//
+template<typename TStorage>
+class ArgScanner : public ArgParserBase, protected TStorage {
+public:
+    bool IsLastArgument(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        for(size_t i=args.size();i>1;i--) {
+            std::string_view arg = args[i - 1];
+            if (arg[0] == '-') {
+                return (arg == shortParamName) || (arg == longParamName);
+            }
+        }
+        return false;
+    }
+
+protected:
+    using ArgParserBase::Report;
+
+    //
+    // Parsing without any bookkeeping, these are const and shared with ArgSnapshot
+    //
+    [[nodiscard]]
+    kParseResult ParsePresent(std::string_view shortParamName, std::string_view longParamName) const {
+        // Only a short name, any of its letters in any short argument or bundle is a match
+        if (longParamName.empty() && (shortParamName.length() > 1) && !shortParamName.starts_with("--")) {
+            return ShortFlags().AnyPresent(shortParamName) ? kParseResult::Ok : kParseResult::OkNotPresent;
+        }
+        auto cbValue = [](const ArgMatch &) { return kParseResult::Ok; };
+        return TryParseInternal(false, cbValue, shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    kParseResult ParseValue(TValue &result, std::string_view shortParamName, std::string_view longParamName, ArgMatch *pMatch = nullptr, ArgError *pError = nullptr) const {
+        auto valueFunc = [&result, pMatch](const ArgMatch &match) -> kParseResult {
+                if (pMatch != nullptr) {
+                    *pMatch = match;
+                }
+                auto res = convert_to<TValue>(match.value);
+                if (!res.has_value()) {
+                    return kParseResult::ErrArgTypeError;
+                }
+                result = *res;
+                return kParseResult::Ok;
+        };
+        return TryParseInternal(true, valueFunc, shortParamName, longParamName, pError);
+    }
+
+    // Values up to the next option handed to 'store' (ArgVectorStore or ArgSpanStore), 'nValues' is the number of
+    // values stored. A value which can't be converted or stored is a type error.
+    template<typename TValue, typename TStore>
+    [[nodiscard]]
+    kParseResult ParseValues(TStore &store, int &nValues, std::string_view shortParamName, std::string_view longParamName, ArgMatch *pMatch = nullptr) const {
+        // lambda to convert an array of TValue
+        // like: '--input_files <f1> <f2> <f3> <f4>
+        auto valueFunc = [&store, &nValues, pMatch, this](ArgMatch &match) -> kParseResult {
+            if (pMatch != nullptr) {
+                *pMatch = match;
+            }
+
+            std::string_view argValue = match.value;
+            size_t idxNext = match.IndexAfterValue();
+            while(true) {
+                auto v = convert_to<TValue>(argValue);
+                if (!v.has_value() || !store.Store(std::move(*v))) {
+                    return kParseResult::ErrArgTypeError;
+                }
+                nValues++;
+                if (idxNext >= args.size()) break;
+                if (args[idxNext][0] == '-') break;
+                match.idxValue = idxNext;
+                argValue = args[idxNext++];
+            }
+            return kParseResult::Ok;
+        };
+        return TryParseInternal(true, valueFunc, shortParamName, longParamName);
+    }
+
+    template<typename TValue, typename TStore>
+    [[nodiscard]]
+    kParseResult ParseList(TStore &store, int &nValues, std::string_view shortParamName, std::string_view longParamName, char separator, ArgMatch *pMatch = nullptr) const {
+        auto valueFunc = [&store, &nValues, separator, pMatch](const ArgMatch &match) -> kParseResult {
+            if (pMatch != nullptr) {
+                *pMatch = match;
+            }
+            std::string_view list = match.value;
+            if constexpr (requires { store.Reserve(size_t{}); }) {
+                store.Reserve(ArgListSplitter::Count(list, separator));
+            }
+            auto cbElement = [&store, &nValues](std::string_view element) -> bool {
+                TValue value = {};
+                if (!ConvertElement(element, value) || !store.Store(std::move(value))) {
+                    return false;
+                }
+                nValues++;
+                return true;
+            };
+            if (!ArgListSplitter::Split(list, separator, cbElement)) {
+                return kParseResult::ErrArgTypeError;
+            }
+            return kParseResult::Ok;
+        };
+        return TryParseInternal(true, valueFunc, shortParamName, longParamName);
+    }
+
+    [[nodiscard]]
+    int CountOccurrences(std::string_view shortParamName, std::string_view longParamName) const {
+        // Short names are counted up front, the index counts long names as complete arguments - anything else must be scanned
+        if (longParamName.empty()) {
+            return ShortFlags().Count(shortParamName);
+        }
+        if constexpr (TStorage::kIndexed) {
+            if (this->argIndex.bValid && longParamName.starts_with("--")) {
+                return ShortFlags().Count(shortParamName) + this->argIndex.CountExact(args, longParamName);
+            }
+        }
+        // We need a specialized version here...
+        int nFound = 0;
+        for(size_t i=0;i<args.size();++i) {
+            std::string_view arg = args[i];
+            if (arg == this->stoparg) {
+                return nFound;
+            }
+            if (!IsValidArgument(arg)) {
+                continue;
+            }
+
+            // simple check if we have a single parameter ('-a' or '--name') with/without arguments
+            if ((arg == longParamName) || (OptionName(arg) == longParamName)) {
+                nFound++;
+            } else {
+                // If this is a 'long' parameter - just skip it...
+                if ((arg.length() > 1) && (arg[0] == '-') && (arg[1] == '-')) continue;
+                // now check every letter in the argument and if they are present in our short parameter name
+                for (size_t j = 1; j < arg.length(); j++) {
+                    if (shortParamName.find(arg[j]) != std::string_view::npos) {
+                        nFound++;
+                    }
+                }
+            }
+        }
+        return nFound;
+    }
+
+    // Returns
+    //  false - indicates an error
+    //  true  - no error
+    template<typename TFunc>
+    [[nodiscard]]
+    kParseResult TryParseInternal(bool bHaveParam, TFunc cbParam, std::string_view shortParamName, std::string_view longParamName = {}, ArgError *pError = nullptr) const {
+        if constexpr (TStorage::kIndexed) {
+            if (this->argIndex.bValid) {
+                return TryParseIndexed(bHaveParam, cbParam, shortParamName, longParamName, pError);
+            }
+        }
+        for(size_t i=0;i<args.size();++i) {
+            std::string_view arg = args[i];
+            if (arg == this->stoparg) {
+                return kParseResult::OkNotPresent;
+            }
+            if (!IsValidArgument(arg)) {
+                continue;
+            }
+
+            std::string_view attached;
+            auto kind = MatchOption(arg, bHaveParam, shortParamName, longParamName, attached);
+            if (kind != kMatch::None) {
+                return CallParam(bHaveParam, cbParam, i, kind, attached, shortParamName, pError);
+            }
+        }
+        return kParseResult::OkNotPresent;
+    }
+
+    // Same as above but resolving the first matching argument through the index
+    template<typename TFunc>
+    [[nodiscard]]
+    kParseResult TryParseIndexed(bool bHaveParam, TFunc cbParam, std::string_view shortParamName, std::string_view longParamName, ArgError *pError) const {
+        size_t i = this->argIndex.FirstMatch(args, shortParamName, longParamName);
+        if (i == ArgIndex::npos) {
+            return kParseResult::OkNotPresent;
+        }
+        std::string_view attached;
+        auto kind = MatchOption(args[i], bHaveParam, shortParamName, longParamName, attached);
+        if (kind == kMatch::None) {
+            return kParseResult::OkNotPresent;
+        }
+        return CallParam(bHaveParam, cbParam, i, kind, attached, shortParamName, pError);
+    }
+
+    template<typename TFunc>
+    [[nodiscard]]
+    kParseResult CallParam(bool bHaveParam, TFunc &cbParam, size_t idxOption, kMatch kind, std::string_view attached, std::string_view shortParamName, ArgError *pError) const {
+        ArgMatch match;
+        match.idxOption = idxOption;
+        match.idxValue = idxOption;
+        if (kind == kMatch::Attached) {
+            match.bAttached = true;
+            match.value = attached;
+        } else if ((idxOption + 1) < args.size()) {
+            // If we have params, make sure there are arguments left to support them...
+            match.idxValue = idxOption + 1;
+            match.value = args[idxOption + 1];
+        } else if (bHaveParam) {
+            return Report(kParseResult::ErrMissingArg, idxOption, idxOption, shortParamName, pError);
+        }
+        auto res = cbParam(match);
+        if (res != kParseResult::Ok) {
+            return Report(res, idxOption, match.idxValue, shortParamName, pError);
+        }
+        return res;
+    }
+
+    // Hands an error to the diagnostics sink (if any), returns the error kind
+    kParseResult Report(kParseResult kind, size_t idxOption, size_t idxArg, std::string_view shortParamName, ArgError *pError = nullptr) const {
+        return Report(diagnostics, MakeError(args, kind, idxOption, idxArg, shortParamName), pError);
+    }
+
+    //
+    // Consumed arguments, one bit per argv index. Short arguments and bundles are tracked per letter instead, a
+    // bundle like '-vxf' is consumed once 'v', 'x' and 'f' have all been asked for.
+    //
+    void ClearConsumed() {
+        this->ResetConsumed(args.size());
+        consumedLetters.reset();
+    }
+
+    void MarkConsumed(size_t idx) {
+        if (idx < args.size()) {
+            this->SetConsumed(idx, args.size());
+        }
+    }
+
+    [[nodiscard]]
+    bool IsConsumed(size_t idx) const {
+        return this->TestConsumed(idx);
+    }
+
+    void MarkLetters(std::string_view shortParamName) {
+        // skip the leading '-' of the name, it is not a letter
+        for(size_t i=shortParamName.starts_with('-')?1:0;i<shortParamName.length();i++) {
+            consumedLetters.set(static_cast<uint8_t>(shortParamName[i]));
+        }
+    }
+
+    [[nodiscard]]
+    bool AllLettersConsumed(std::string_view arg) const {
+        for(size_t j=1;j<arg.length();j++) {
+            if (!consumedLetters.test(static_cast<uint8_t>(arg[j]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A matched option with 'nValues' values, the first one possibly attached
+    void MarkOption(const ArgMatch &match, size_t nValues, std::string_view shortParamName, std::string_view longParamName) {
+        std::string_view arg = args[match.idxOption];
+        if (match.bAttached || (arg == shortParamName) || (arg == longParamName)) {
+            MarkConsumed(match.idxOption);
+        } else {
+            // found through a letter in a bundle
+            MarkLetters(shortParamName);
+        }
+        size_t nFollowing = match.bAttached ? (nValues - 1) : nValues;
+        for(size_t i=0;i<nFollowing;i++) {
+            MarkConsumed(match.idxOption + 1 + i);
+        }
+    }
+
+    // Flags consume every occurrence, not only the first one. Instead of scanning argv for each flag the long name
+    // is remembered (copied, the name may be a temporary) and compared with the remaining long arguments in
+    // Unconsumed. Once fixed storage is out of slots every occurrence is marked right away instead.
+    void MarkFlag(std::string_view shortParamName, std::string_view longParamName) {
+        MarkLetters(shortParamName);
+        if (longParamName.empty() || this->HasConsumedFlag(longParamName) || this->AddConsumedFlag(longParamName)) {
+            return;
+        }
+        for(size_t i=1;i<args.size();i++) {
+            std::string_view arg = args[i];
+            if (arg == this->stoparg) {
+                break;
+            }
+            if (arg.starts_with("--") && (OptionName(arg) == longParamName)) {
+                MarkConsumed(i);
+            }
+        }
+    }
+
+    // Calls 'cbArg' for every argument no query has used, see ArgParser::Unconsumed. Returns the number of
+    // arguments or -1 if 'cbArg' returned false.
+    template<typename TFunc>
+    int ForEachUnconsumed(TFunc cbArg) const {
+        auto idxEnd = IndexOfEndArgs();
+        int nFound = 0;
+        for(size_t i=1;i<idxEnd;i++) {
+            std::string_view arg = args[i];
+            if (arg == this->stoparg) {
+                break;
+            }
+            if (IsConsumed(i)) {
+                continue;
+            }
+            if (arg.starts_with("--")) {
+                if (this->HasConsumedFlag(OptionName(arg))) {
+                    continue;
+                }
+            } else if (IsValidArgument(arg) && (arg.length() > 1) && AllLettersConsumed(arg)) {
+                // short arguments and bundles are used once every letter has been asked for
+                continue;
+            }
+            if (!cbArg(arg)) {
+                return -1;
+            }
+            nFound++;
+        }
+        return nFound;
+    }
+
+    // Index of the first end argument (or args.size() if there are none), the end arguments are the trailing
+    // arguments which are neither consumed nor a '-<name>'
+    [[nodiscard]]
+    size_t IndexOfEndArgs() const {
+        size_t idx = args.size();
+        while((idx > 1) && !IsConsumed(idx - 1) && (args[idx - 1][0] != '-')) {
+            --idx;
+        }
+        return idx;
+    }
+
+    // Letters of the short arguments, built on the first query which needs them
+    [[nodiscard]]
+    const ArgShortFlags &ShortFlags() const {
+        if (!shortFlags.bValid) {
+            shortFlags.Build(args, this->stoparg);
+        }
+        return shortFlags;
+    }
+
+    std::span<const char *> args = {};
+    ArgDiagnostics diagnostics;
+    mutable ArgShortFlags shortFlags;
+    std::bitset<256> consumedLetters;
+};
+
+class ArgParser : public ArgScanner<ArgParserBase::ArgDynamicStorage> {
+    template<typename... TOptions> friend class ArgSchema;
+    template<typename TConfig> friend class ArgBinder;
+    friend class ArgSnapshot;
+    template<ArgName... Names> friend class ArgSubcommands;
+    friend class ArgCompletion;
+public:
+    ArgParser() = delete;
+    ArgParser(size_t argc, const char **argv) {
+        args = {argv, argc};
+        ClearConsumed();
+        Rescan();
+    }
+    virtual ~ArgParser() = default;
+
+    // Rebind the parser to a new argv, the stop condition and the index setting are kept.
+    // Allocated capacity is reused, parsing many command lines with one parser does not allocate once warmed up.
+    void Reset(size_t argc, const char **argv) {
+        args = {argv, argc};
+        expandedArgs.reset();
+        ClearConsumed();
+        Rescan();
+    }
+
+    // Every parse error is passed to the sink, none by default - the parser itself never writes anything
+    void SetDiagnostics(ArgDiagnostics::Callback cbReport, void *context = nullptr) {
+        diagnostics = {cbReport, context};
+    }
+
+    void SetStopCondition(std::string_view stopArg) {
+        stoparg = stopArg;
+        // the short flags and the index depend on where we stop
+        Rescan();
+    }
+
+    // Environment used for the ArgEnv fallbacks, like the 'envp' of main. Without one 'environ' is indexed on the
+    // first fallback. The index is built once and kept over Reset, values point into the environment strings.
+    void SetEnvironment(const char *const *envp) {
+        environment.Build(envp);
+    }
+
+    // Config file with defaults for options not on the command line (or in the environment), keys are the long
+    // option names without '--'. Returns false if the file can't be read or is malformed, the previous config is
+    // kept in that case - use SetConfig with an ArgConfigFile of your own for the line of the error.
+    bool LoadConfig(const char *filename) {
+        auto file = std::make_shared<ArgConfigFile>();
+        if (!file->Open(filename)) {
+            return false;
+        }
+        config = std::move(file);
+        return true;
+    }
+
+    void SetConfig(std::shared_ptr<const ArgConfigFile> configFile) {
+        config = std::move(configFile);
+    }
+
+    // Replace every '@file' argument with the arguments in that file (nested response files are expanded as well).
+    // The program name and everything from the stop condition on are kept as they are, set the stop condition first.
+    // Returns false if any of the files could not be read, argv is left untouched in that case.
+    bool ExpandResponseFiles() {
+        if (args.empty()) {
+            return true;
+        }
+        auto expanded = std::make_shared<ExpandedArgs>();
+        expanded->argv.reserve(args.size());
+        // arguments not expanded this time may still point into files from a previous expansion
+        expanded->previous = expandedArgs;
+        expanded->argv.push_back(args[0]);
+        bool bStopped = false;
+        if (!ExpandResponseFiles(*expanded, args.subspan(1), stoparg, 0, bStopped)) {
+            return false;
+        }
+        expandedArgs = std::move(expanded);
+        args = std::span<const char *>(expandedArgs->argv);
+        ClearConsumed();
+        Rescan();
+        return true;
+    }
+
+    // Immutable snapshot of the parser - all queries are const and the snapshot can be shared between threads
+    [[nodiscard]]
+    ArgSnapshot Freeze() const;
+
+    // Parser over the arguments from 'idxCommand' on, like the arguments of 'commit' in 'git -v commit -m msg'.
+    // The argument at 'idxCommand' takes the place of the program name. The slice points into our argv, nothing is
+    // copied. The stop condition, diagnostics, environment, config and index setting are inherited, the stop
+    // condition can be changed on the new parser without affecting this one. See ArgSubcommands.
+    [[nodiscard]]
+    ArgParser Subcommand(size_t idxCommand) const {
+        return ArgParser(*this, std::min(idxCommand, args.size()));
+    }
+
+    // Tokenize argv once and answer all later queries from a lookup table instead of scanning argv.
+    // Opt-in, pays off when many options are queried against a large argv (like generated file lists).
+    // The short flags are built with it, an indexed parser (like a snapshot) is then never modified by a query.
+    void BuildIndex() {
+        argIndex.Build(args, stoparg);
+        shortFlags.Build(args, stoparg);
+    }
+
+    // Parse flags (true/false) based on presence of an option...  expecting no arguments...
+    [[nodiscard]]
+    bool IsPresent(std::string_view shortParamName, std::string_view longParamName = {}) {
+        if (ParsePresent(shortParamName, longParamName) != kParseResult::Ok) {
+            // a flag in the config file is a boolean, like 'verbose = true'
+            bool bFlag = false;
+            return (ParseFallback(bFlag, longParamName, {}, nullptr) == kParseResult::Ok) && bFlag;
+        }
+        MarkFlag(shortParamName, longParamName);
+        return true;
+    }
+
+    // Parse an argument with a single expected value - without default (can be treated as 'must have')
+    // Must be called explicitly like: 'TryParse<int>(...)' as C++ can't/won't deduce type-specification based on the return
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(std::string_view shortParamName, std::string_view longParamName = {}) {
+        return TryParse<TValue>({}, shortParamName, longParamName);
+    }
+
+    // Same as above but for r-value ref's
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &&defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        return TryParse(defaultValue, shortParamName, longParamName);
+    }
+
+    // Parse an argument with a single expected value - using a default value if arument is not present...
+    // type deduction based on the default value...
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        // pre-populate with default value, will be set to parsed/converted value if everything works out...
+        TValue result = {defaultValue};
+        ArgMatch match;
+        auto res = ParseValue(result, shortParamName, longParamName, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        } else if (res == kParseResult::OkNotPresent) {
+            res = ParseFallback(result, longParamName, {}, nullptr);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+
+        return {};
+    }
+
+    // Same as above with an environment variable as fallback, the command line wins over the environment and the
+    // environment over the default. A value from the environment is a slice of the environment string.
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(std::string_view shortParamName, std::string_view longParamName, ArgEnv env) {
+        return TryParse<TValue>({}, shortParamName, longParamName, env);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName, ArgEnv env) {
+        TValue result = {defaultValue};
+        ArgMatch match;
+        auto res = ParseValue(result, shortParamName, longParamName, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+            return result;
+        }
+        if (res == kParseResult::OkNotPresent) {
+            BuildEnvironment();
+            res = ParseFallback(result, longParamName, env.name, nullptr);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return {};
+    }
+
+    // Same as TryParse but a failure says why: the error kind, the argv index and the option name
+    // Without a default a missing option is an error as well (kind 'OkNotPresent')
+    template<typename TValue>
+    [[nodiscard]]
+    ArgResult<TValue> Parse(std::string_view shortParamName, std::string_view longParamName = {}) {
+        TValue result = {};
+        ArgMatch match;
+        ArgError error;
+        auto res = ParseValue(result, shortParamName, longParamName, &match, &error);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+            return result;
+        }
+        if (res == kParseResult::OkNotPresent) {
+            res = ParseFallback(result, longParamName, {}, &error);
+            if (res == kParseResult::Ok) {
+                return result;
+            }
+        }
+        if (res == kParseResult::OkNotPresent) {
+            return ArgError{res, 0, longParamName.empty() ? shortParamName : longParamName};
+        }
+        return error;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    ArgResult<TValue> Parse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        TValue result = {defaultValue};
+        ArgMatch match;
+        ArgError error;
+        auto res = ParseValue(result, shortParamName, longParamName, &match, &error);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        } else if (res == kParseResult::OkNotPresent) {
+            res = ParseFallback(result, longParamName, {}, &error);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return error;
+    }
+
+    // Parse an argument with an array as expected value
+    template<typename TValue>
+    [[nodiscard]]
+    int TryParse(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}) {
+        int nValues = 0;
+        ArgMatch match;
+        ArgVectorStore<TValue> store{outValues};
+        auto res = ParseValues<TValue>(store, nValues, shortParamName, longParamName, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, static_cast<size_t>(nValues), shortParamName, longParamName);
+            // the number of values following the first one
+            return nValues - 1;
+        }
+        return 0;
+    }
+
+    // Parse an argument holding a delimited list, like: '--ids 1,2,3'
+    // Returns the number of values, 0 if not present and -1 if any of the values could not be converted
+    template<typename TValue>
+    int TryParseList(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}, char separator = ',') {
+        int nValues = 0;
+        ArgMatch match;
+        ArgVectorStore<TValue> store{outValues};
+        auto res = ParseList<TValue>(store, nValues, shortParamName, longParamName, separator, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+            return nValues;
+        }
+        if (res == kParseResult::OkNotPresent) {
+            return 0;
+        }
+        return -1;
+    }
+
+    // Collect every occurrence of an option, like: '-I dir1 -I dir2 -I dir3' or '-Idir1 --include=dir2'
+    // Only complete names ('-I', '--include') are matched, each occurrence takes the next argument (or the attached
+    // value) as its value. Returns the number of values, 0 if not present and -1 on a missing or unconvertible value
+    template<typename TValue>
+    int TryParseAll(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}) {
+        auto cbMark = [this, shortParamName, longParamName](const ArgMatch &match) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        };
+        return CollectAll(outValues, shortParamName, longParamName, cbMark);
+    }
+
+    // Collect every occurrence of a 'key=value' option into a flat list of pairs, like: '-D NAME=1 -D OTHER'
+    // Keys and values point into argv, a definition without separator gets an empty value.
+    // Returns the number of pairs, 0 if not present and -1 on a missing value
+    int TryParseMap(std::vector<std::pair<std::string_view, std::string_view>> &outPairs, std::string_view shortParamName, std::string_view longParamName = {}, char separator = '=') {
+        auto cbMark = [this, shortParamName, longParamName](const ArgMatch &match) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        };
+        return CollectMap(outPairs, shortParamName, longParamName, separator, cbMark);
+    }
+
+    [[nodiscard]]
+    int CountPresence(std::string_view shortParamName, std::string_view longParamName = {}) {
+        int nFound = CountOccurrences(shortParamName, longParamName);
+        if (nFound > 0) {
+            MarkFlag(shortParamName, longParamName);
+        }
+        return nFound;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    int CopyEndArgs(std::vector<TValue> &outValues, bool append = true) const {
+        auto idxStart = IndexOfEndArgs();
+        // nothing but prgname was supplied or there was no end-of-cmdline parameters passed
+        if (idxStart == args.size()) {
+            return 0;
+        }
+
+        if (!append) {
+            outValues.clear();
+        }
+        outValues.reserve(outValues.size() + (args.size() - idxStart));
+
+        int nValues = 0;
+        for(auto it = args.begin() + idxStart; it != args.end(); ++it) {
+            auto res = convert_to<TValue>(*it);
+            if (!res.has_value()) {
+                return -1;
+            }
+            outValues.push_back(*res);
+            nValues++;
+        }
+
+        return nValues;
+    }
+
+    // Same as CopyEndArgs but for very large tails (like millions of ids), the output is sized up front and chunks of
+    // arguments are converted on 'nThreads' threads (0 - one per core). Threads pick the next chunk from a shared
+    // counter, so a slow chunk doesn't hold up the others. Input order is kept.
+    // On error -1 is returned and 'outValues' holds the values before the first argument that could not be converted,
+    // regardless of which thread found it first. A conversion which throws is rethrown on the calling thread once all
+    // threads are done, 'outValues' is then back to what it was before (with 'append'). If threads can't be created
+    // the calling thread converts the remaining chunks itself.
+    template<typename TValue>
+    [[nodiscard]]
+    int CopyEndArgsParallel(std::vector<TValue> &outValues, bool append = true, size_t nThreads = 0) const {
+        // std::vector<bool> packs bits, neighbouring elements can't be written from different threads
+        if constexpr (std::is_same_v<TValue, bool>) {
+            return CopyEndArgs(outValues, append);
+        } else {
+            return CopyEndArgsChunked(outValues, append, nThreads);
+        }
+    }
+
+    // Arguments no query has used, like misspelled options ('--thread 8' when asking for '--threads').
+    // Everything before the stop condition and the end arguments is checked in a single pass, call this after
+    // all options have been queried. The stop argument and everything after it is never reported, those arguments
+    // belong to whoever comes after the stop condition (see CopyAllAfter). Returns the number of arguments added to
+    // 'outArgs'.
+    int Unconsumed(std::vector<std::string_view> &outArgs) const {
+        return ForEachUnconsumed([&outArgs](std::string_view arg) {
+            outArgs.push_back(arg);
+            return true;
+        });
+    }
+
+    // Lazy view over the values of an option, like: '--input <f1> <f2> <f3>'
+    // Nothing is copied up front, values are converted while iterating. Each element is a std::optional<TValue>
+    // which is empty if that particular value could not be converted.
+    template<typename TValue>
+    [[nodiscard]]
+    auto Values(std::string_view shortParamName, std::string_view longParamName = {}) {
+        ArgMatch match;
+        bool bFound = FindValues(shortParamName, longParamName, match);
+        if (bFound) {
+            MarkOption(match, CountValues(match), shortParamName, longParamName);
+        }
+        return ValuesView<TValue>(args, match, bFound);
+    }
+
+    // Lazy view over the end arguments, same arguments as CopyEndArgs but converted while iterating
+    template<typename TValue>
+    [[nodiscard]]
+    auto EndArgs() const {
+        auto argv = args;
+        return std::views::iota(IndexOfEndArgs(), argv.size())
+               | std::views::transform([argv](size_t idx) { return convert_to<TValue>(argv[idx]); });
+    }
+
+    int CopyAllAfter(std::vector<std::string> &outValues, std::string_view param) const {
+        auto itParam = std::find_if(args.begin(), args.end(), [&](const std::string_view &arg) { return arg == param; });
+        if (itParam == args.end()) {
+            return -1;
+        }
+        ++itParam;
+        while(itParam != args.end()) {
+            outValues.push_back(*itParam);
+            ++itParam;
+        }
+        return (int)outValues.size();
+    }
+
+protected:
+    ArgParser(const ArgParser &parent, size_t idxFirst) : environment(parent.environment), config(parent.config),
+                                                          expandedArgs(parent.expandedArgs) {
+        args = parent.args.subspan(idxFirst);
+        stoparg = parent.stoparg;
+        diagnostics = parent.diagnostics;
+        ClearConsumed();
+        Rescan();
+        if (parent.argIndex.bValid) {
+            BuildIndex();
+        }
+    }
+
+    // Index 'environ' on the first ArgEnv fallback unless SetEnvironment was called
+    void BuildEnvironment() {
+        if (!environment.IsBuilt()) {
+            environment.Build(GNILK_ARGPARSER_ENVIRON);
+        }
+    }
+
+    // Value of an option not on the command line, the environment variable (if any) wins over the config file.
+    // Returns 'OkNotPresent' if neither has it. With an 'envName' the environment must be built (BuildEnvironment).
+    template<typename TValue>
+    [[nodiscard]]
+    kParseResult ParseFallback(TValue &result, std::string_view longParamName, std::string_view envName, ArgError *pError) const {
+        std::optional<std::string_view> value;
+        std::string_view source = envName;
+        size_t idxSource = ArgError::kEnvironment;
+        if (!envName.empty()) {
+            value = environment.Find(envName);
+        }
+        if (!value.has_value() && (config != nullptr) && !longParamName.empty()) {
+            source = longParamName.substr(std::min(longParamName.find_first_not_of('-'), longParamName.size()));
+            idxSource = ArgError::kConfig;
+            value = config->Find(source);
+        }
+        if (!value.has_value()) {
+            return kParseResult::OkNotPresent;
+        }
+        auto converted = convert_to<TValue>(*value);
+        if (!converted.has_value()) {
+            return Report(diagnostics, ArgError{kParseResult::ErrArgTypeError, idxSource, source}, pError);
+        }
+        result = std::move(*converted);
+        return kParseResult::Ok;
+    }
+
+    // The index only finds the first occurrence and sizes the output for the accumulating options, on a short argv
+    // scanning from the start is cheaper
+    [[nodiscard]]
+    bool IsIndexWorthIt() const {
+        return argIndex.bValid && (args.size() >= kAccumulateIndexMinArgs);
+    }
+
+    //
+    // Accumulating options, one linear pass from the first occurrence calling 'cbValue' for each value
+    //
+    template<typename TFunc>
+    [[nodiscard]]
+    kParseResult ParseEach(TFunc cbValue, std::string_view shortParamName, std::string_view longParamName) const {
+        size_t idxStart = 0;
+        if (IsIndexWorthIt()) {
+            idxStart = std::min(argIndex.FirstExact(args, shortParamName), argIndex.FirstExact(args, longParamName));
+            // attached to a single letter short name, like '-DNAME=1'
+            if ((shortParamName.length() == 2) && (shortParamName[0] == '-')) {
+                idxStart = std::min(idxStart, argIndex.FirstWithLetter(shortParamName[1]));
+            }
+            if (idxStart == ArgIndex::npos) {
+                return kParseResult::OkNotPresent;
+            }
+        }
+        auto result = kParseResult::OkNotPresent;
+        for(size_t i=idxStart;i<args.size();++i) {
+            // compare in place, most arguments are values and rejected on the first character without a strlen
+            const char *arg = args[i];
+            if (IsEqual(arg, stoparg)) {
+                break;
+            }
+            if (arg[0] != '-') {
+                continue;
+            }
+            ArgMatch match;
+            auto kind = MatchOption(arg, true, shortParamName, longParamName, match.value);
+            if ((kind != kMatch::Exact) && (kind != kMatch::Attached)) {
+                continue;
+            }
+            match.idxOption = i;
+            match.idxValue = i;
+            match.bAttached = (kind == kMatch::Attached);
+            if (!match.bAttached) {
+                if ((i + 1) >= args.size()) {
+                    return Report(kParseResult::ErrMissingArg, i, i, shortParamName);
+                }
+                match.idxValue = ++i;
+                match.value = args[i];
+            }
+            auto res = cbValue(match);
+            if (res != kParseResult::Ok) {
+                return Report(res, match.idxOption, match.idxValue, shortParamName);
+            }
+            result = kParseResult::Ok;
+        }
+        return result;
+    }
+
+    template<typename TValue, typename TMark>
+    int CollectAll(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName, TMark cbMark) const {
+        if (IsIndexWorthIt()) {
+            outValues.reserve(outValues.size() + argIndex.CountExact(args, shortParamName) + argIndex.CountExact(args, longParamName));
+        }
+        int nValues = 0;
+        auto cbValue = [&outValues, &nValues, &cbMark](const ArgMatch &match) -> kParseResult {
+            auto v = convert_to<TValue>(match.value);
+            if (!v.has_value()) {
+                return kParseResult::ErrArgTypeError;
+            }
+            outValues.push_back(std::move(*v));
+            cbMark(match);
+            nValues++;
+            return kParseResult::Ok;
+        };
+        auto res = ParseEach(cbValue, shortParamName, longParamName);
+        return ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) ? nValues : -1;
+    }
+
+    template<typename TMark>
+    int CollectMap(std::vector<std::pair<std::string_view, std::string_view>> &outPairs, std::string_view shortParamName, std::string_view longParamName, char separator, TMark cbMark) const {
+        if (IsIndexWorthIt()) {
+            outPairs.reserve(outPairs.size() + argIndex.CountExact(args, shortParamName) + argIndex.CountExact(args, longParamName));
+        }
+        int nPairs = 0;
+        auto cbValue = [&outPairs, &nPairs, &cbMark, separator](const ArgMatch &match) -> kParseResult {
+            std::string_view definition = match.value;
+            auto idxSeparator = definition.find(separator);
+            if (idxSeparator == std::string_view::npos) {
+                outPairs.emplace_back(definition, std::string_view{});
+            } else {
+                outPairs.emplace_back(definition.substr(0, idxSeparator), definition.substr(idxSeparator + 1));
+            }
+            cbMark(match);
+            nPairs++;
+            return kParseResult::Ok;
+        };
+        auto res = ParseEach(cbValue, shortParamName, longParamName);
+        return ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) ? nPairs : -1;
+    }
+
+    // Convert the end arguments straight into their slot of 'outValues', chunk by chunk from any number of threads
+    template<typename TValue>
+    int CopyEndArgsChunked(std::vector<TValue> &outValues, bool append, size_t nThreads) const {
+        auto idxStart = IndexOfEndArgs();
+        if (idxStart == args.size()) {
+            return 0;
+        }
+        if (!append) {
+            outValues.clear();
+        }
+        size_t nArgs = args.size() - idxStart;
+        size_t idxOutput = outValues.size();
+        outValues.resize(idxOutput + nArgs);
+
+        // first failing argument (relative to idxStart), threads stop when they are past it
+        std::atomic<size_t> idxFirstError = SIZE_MAX;
+        std::atomic<size_t> idxNextChunk = 0;
+        // first exception thrown by a conversion, all threads stop once there is one
+        std::exception_ptr firstException;
+        std::mutex lockException;
+        std::atomic<bool> bThrown = false;
+        auto worker = [&]() {
+            try {
+                while(!bThrown.load(std::memory_order_relaxed)) {
+                    size_t idxChunk = idxNextChunk.fetch_add(kParallelChunkSize, std::memory_order_relaxed);
+                    if ((idxChunk >= nArgs) || (idxChunk > idxFirstError.load(std::memory_order_relaxed))) {
+                        return;
+                    }
+                    size_t idxEnd = std::min(idxChunk + kParallelChunkSize, nArgs);
+                    for(size_t i=idxChunk;i<idxEnd;i++) {
+                        if (!ConvertElement(std::string_view(args[idxStart + i]), outValues[idxOutput + i])) {
+                            size_t idxError = idxFirstError.load(std::memory_order_relaxed);
+                            while((i < idxError) && !idxFirstError.compare_exchange_weak(idxError, i, std::memory_order_relaxed)) {
+                            }
+                            break;
+                        }
+                    }
+                }
+            } catch(...) {
+                std::lock_guard<std::mutex> guard(lockException);
+                if (firstException == nullptr) {
+                    firstException = std::current_exception();
+                }
+                bThrown = true;
+            }
+        };
+
+        if (nThreads == 0) {
+            nThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        nThreads = std::min(nThreads, (nArgs + kParallelChunkSize - 1) / kParallelChunkSize);
+        {
+            // joins whatever was started, also when starting the next thread fails
+            struct JoinAll {
+                ~JoinAll() {
+                    for(auto &thread : threads) {
+                        thread.join();
+                    }
+                }
+                std::vector<std::thread> threads;
+            } joinAll;
+            joinAll.threads.reserve(nThreads - 1);
+            for(size_t i=1;i<nThreads;i++) {
+                try {
+                    joinAll.threads.emplace_back(worker);
+                } catch(const std::system_error &) {
+                    // chunks are picked from the shared counter, the threads we have (and this one) take the rest
+                    break;
+                }
+            }
+            // the calling thread takes its share as well
+            worker();
+        }
+
+        if (firstException != nullptr) {
+            outValues.resize(idxOutput);
+            std::rethrow_exception(firstException);
+        }
+        size_t idxError = idxFirstError.load();
+        if (idxError != SIZE_MAX) {
+            outValues.resize(idxOutput + idxError);
+            return -1;
+        }
+        return static_cast<int>(nArgs);
+    }
+
+    // The option and its first value, false if not present
+    [[nodiscard]]
+    bool FindValues(std::string_view shortParamName, std::string_view longParamName, ArgMatch &outMatch) const {
+        auto cbValue = [&outMatch](const ArgMatch &match) {
+            outMatch = match;
+            return kParseResult::Ok;
+        };
+        return TryParseInternal(true, cbValue, shortParamName, longParamName) == kParseResult::Ok;
+    }
+
+    // Number of values of a matched option, same rule as for TryParse with a vector; the first value is always
+    // taken, then up to the next '-<name>'
+    [[nodiscard]]
+    size_t CountValues(const ArgMatch &match) const {
+        size_t idx = match.IndexAfterValue();
+        size_t nValues = 1;
+        while((idx < args.size()) && (args[idx][0] != '-')) {
+            ++idx;
+            ++nValues;
+        }
+        return nValues;
+    }
+
+    template<typename TValue>
+    static auto ValuesView(std::span<const char *> argv, const ArgMatch &match, bool bFound) {
+        // the first value may be attached to the option, it is then found at the index of the option
+        size_t idxFirst = bFound ? (match.IndexAfterValue() - 1) : argv.size();
+        std::string_view firstValue = match.value;
+        return std::views::iota(idxFirst, argv.size())
+               | std::views::take_while([argv, idxFirst](size_t idx) { return (idx == idxFirst) || (argv[idx][0] != '-'); })
+               | std::views::transform([argv, idxFirst, firstValue](size_t idx) {
+                   return convert_to<TValue>((idx == idxFirst) ? firstValue : std::string_view(argv[idx]));
+               });
+    }
+
+    // The expanded argv and the response files it points into, shared between copies of the parser
+    struct ExpandedArgs {
+        std::vector<const char *> argv;
+        std::vector<std::unique_ptr<ArgResponseFile>> files;
+        std::shared_ptr<ExpandedArgs> previous;
+    };
+
+    static constexpr int kMaxResponseFileDepth = 8;
+    // below this many arguments the index lookups of the accumulating options cost more than the scan they save
+    static constexpr size_t kAccumulateIndexMinArgs = 32;
+    // number of end arguments converted per task in CopyEndArgsParallel
+    static constexpr size_t kParallelChunkSize = 16384;
+
+    // 'bStopped' is set once the stop argument has been seen, in argv or in a response file - everything after it
+    // is passed on as is
+    static bool ExpandResponseFiles(ExpandedArgs &expanded, std::span<const char * const> srcArgs, std::string_view stopArg, int depth, bool &bStopped) {
+        for(auto arg : srcArgs) {
+            if (!bStopped && !stopArg.empty() && (arg == stopArg)) {
+                bStopped = true;
+            }
+            if (bStopped || (arg[0] != '@') || (arg[1] == '\0')) {
+                expanded.argv.push_back(arg);
+                continue;
+            }
+            if (depth >= kMaxResponseFileDepth) {
+                return false;
+            }
+            auto file = std::make_unique<ArgResponseFile>();
+            if (!file->Open(arg + 1)) {
+                return false;
+            }
+            auto tokens = file->Tokens();
+            // grown geometrically, many small response files must not reallocate argv for each of them
+            auto szNeeded = expanded.argv.size() + tokens.size();
+            if (expanded.argv.capacity() < szNeeded) {
+                expanded.argv.reserve(std::max(szNeeded, expanded.argv.capacity() * 2));
+            }
+            expanded.files.push_back(std::move(file));
+            if (!ExpandResponseFiles(expanded, tokens, stopArg, depth + 1, bStopped)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Update everything derived from argv and the stop condition, the short flags are rebuilt when next needed
+    void Rescan() {
+        shortFlags.bValid = false;
+        if (argIndex.bValid) {
+            BuildIndex();
+        }
+    }
+private:
+    ArgEnvironment environment;
+    std::shared_ptr<const ArgConfigFile> config;
+    std::shared_ptr<ExpandedArgs> expandedArgs;
+};
+
+//
+// Immutable, thread safe snapshot of an ArgParser
+//
+// The snapshot builds the index up front, after that nothing is ever modified - so it can be queried from any number
+// of threads without synchronisation. Queries on the snapshot don't mark arguments as consumed (see Unconsumed), the end
+// arguments are those of the parser at the time it was frozen. Options not on the command line fall back to the
+// environment (ArgEnv) and the config file like on the parser, the environment is indexed when freezing (unless
+// SetEnvironment was called) so variables set after that are not seen.
+//
+// Use like:
+//      ArgParser argParser(argc, argv);
+//      auto input = argParser.TryParse(std::string("input.file"), "-i", "--input");
+//      const auto snapshot = argParser.Freeze();
+//      // share 'snapshot' with worker threads, from any thread:
+//      auto threads = snapshot.TryParse(4, "-t", "--threads");
+//
+class ArgSnapshot {
+public:
+    using kParseResult = ArgParser::kParseResult;
+public:
+    ArgSnapshot() = delete;
+    explicit ArgSnapshot(const ArgParser &argParser) : parser(WithIndex(argParser)) {
+    }
+    virtual ~ArgSnapshot() = default;
+
+    [[nodiscard]]
+    bool IsPresent(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        if (parser.ParsePresent(shortParamName, longParamName) == kParseResult::Ok) {
+            return true;
+        }
+        bool bFlag = false;
+        return (parser.ParseFallback(bFlag, longParamName, {}, nullptr) == kParseResult::Ok) && bFlag;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return TryParse<TValue>({}, shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &&defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return TryParse(defaultValue, shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return TryParse(defaultValue, shortParamName, longParamName, ArgEnv({}));
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(std::string_view shortParamName, std::string_view longParamName, ArgEnv env) const {
+        return TryParse<TValue>({}, shortParamName, longParamName, env);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName, ArgEnv env) const {
+        TValue result = {defaultValue};
+        auto res = parser.ParseValue(result, shortParamName, longParamName);
+        if (res == kParseResult::OkNotPresent) {
+            res = parser.ParseFallback(result, longParamName, env.name, nullptr);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return {};
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    ArgParser::ArgResult<TValue> Parse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) const {
+        TValue result = {defaultValue};
+        ArgParser::ArgError error;
+        auto res = parser.ParseValue(result, shortParamName, longParamName, nullptr, &error);
+        if (res == kParseResult::OkNotPresent) {
+            res = parser.ParseFallback(result, longParamName, {}, &error);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return error;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    int TryParse(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}) const {
+        int nValues = 0;
+        ArgParser::ArgVectorStore<TValue> store{outValues};
+        auto res = parser.ParseValues<TValue>(store, nValues, shortParamName, longParamName);
+        return (res == kParseResult::Ok) ? (nValues - 1) : 0;
+    }
+
+    template<typename TValue>
+    int TryParseList(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}, char separator = ',') const {
+        int nValues = 0;
+        ArgParser::ArgVectorStore<TValue> store{outValues};
+        auto res = parser.ParseList<TValue>(store, nValues, shortParamName, longParamName, separator);
+        if (res == kParseResult::Ok) {
+            return nValues;
+        }
+        return (res == kParseResult::OkNotPresent) ? 0 : -1;
+    }
+
+    template<typename TValue>
+    int TryParseAll(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return parser.CollectAll(outValues, shortParamName, longParamName, [](const ArgParser::ArgMatch &) {});
+    }
+
+    int TryParseMap(std::vector<std::pair<std::string_view, std::string_view>> &outPairs, std::string_view shortParamName, std::string_view longParamName = {}, char separator = '=') const {
+        return parser.CollectMap(outPairs, shortParamName, longParamName, separator, [](const ArgParser::ArgMatch &) {});
+    }
+
+    [[nodiscard]]
+    int CountPresence(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return parser.CountOccurrences(shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    int CopyEndArgs(std::vector<TValue> &outValues, bool append = true) const {
+        return parser.CopyEndArgs(outValues, append);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    int CopyEndArgsParallel(std::vector<TValue> &outValues, bool append = true, size_t nThreads = 0) const {
+        return parser.CopyEndArgsParallel(outValues, append, nThreads);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    auto Values(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        ArgParser::ArgMatch match;
+        bool bFound = parser.FindValues(shortParamName, longParamName, match);
+        return ArgParser::ValuesView<TValue>(parser.args, match, bFound);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    auto EndArgs() const {
+        return parser.EndArgs<TValue>();
+    }
+
+    int CopyAllAfter(std::vector<std::string> &outValues, std::string_view param) const {
+        return parser.CopyAllAfter(outValues, param);
+    }
+
+    [[nodiscard]]
+    bool IsLastArgument(std::string_view shortParamName, std::string_view longParamName = {}) const {
+        return parser.IsLastArgument(shortParamName, longParamName);
+    }
+
+protected:
+    // The environment is indexed here as well, the ArgEnv fallbacks never modify the snapshot
+    static ArgParser WithIndex(const ArgParser &argParser) {
+        ArgParser copy(argParser);
+        copy.BuildIndex();
+        copy.BuildEnvironment();
+        return copy;
+    }
+private:
+    const ArgParser parser;
+};
+
+inline ArgSnapshot ArgParser::Freeze() const {
+    return ArgSnapshot(*this);
+}
+
+//
+// Heap free variant of ArgParser for startup critical tools, like the ones running before the allocator is set up.
+// All state lives in the object, 'MaxArgs' bounds argc and 'MaxOptions' the number of long flags remembered for
+// Unconsumed (more flags are marked by scanning argv instead). Nothing throws and nothing allocates as long as the
+// results don't - use std::string_view instead of std::string and the std::span overloads instead of vectors.
+// Same behaviour as ArgParser for the queries it has - both scan through ArgScanner, only the storage differs. There
+// is no index, response files, snapshots or threads.
+//
+// Use like:
+//      StaticArgParser<16, 64> argParser(argc, argv);
+//      if (!argParser.IsValid()) { ... more than 64 arguments ... }
+//      auto root = argParser.TryParse(std::string_view("/"), "-r", "--root");
+//
+template<size_t MaxOptions, size_t MaxArgs>
+class StaticArgParser : public ArgScanner<ArgParserBase::ArgFixedStorage<MaxOptions, MaxArgs>> {
+    using Scanner = ArgScanner<ArgParserBase::ArgFixedStorage<MaxOptions, MaxArgs>>;
+public:
+    using kParseResult = ArgParserBase::kParseResult;
+    using ArgError = ArgParserBase::ArgError;
+    using ArgDiagnostics = ArgParserBase::ArgDiagnostics;
+    template<typename TValue>
+    using ArgResult = ArgParserBase::ArgResult<TValue>;
+public:
+    StaticArgParser() = delete;
+    StaticArgParser(size_t argc, const char **argv) {
+        Reset(argc, argv);
+    }
+
+    // False if argv had more than 'MaxArgs' arguments, only the first 'MaxArgs' are seen in that case
+    [[nodiscard]]
+    bool IsValid() const {
+        return bValid;
+    }
+
+    void Reset(size_t argc, const char **argv) {
+        bValid = (argc <= MaxArgs);
+        args = {argv, std::min(argc, MaxArgs)};
+        ClearConsumed();
+        shortFlags.bValid = false;
+    }
+
+    void SetDiagnostics(ArgDiagnostics::Callback cbReport, void *context = nullptr) {
+        diagnostics = {cbReport, context};
+    }
+
+    // The stop argument is referenced, not copied - it must outlive the parser
+    void SetStopCondition(std::string_view stopArg) {
+        stoparg = stopArg;
+        shortFlags.bValid = false;
+    }
+
+    [[nodiscard]]
+    bool IsPresent(std::string_view shortParamName, std::string_view longParamName = {}) {
+        if (ParsePresent(shortParamName, longParamName) != kParseResult::Ok) {
+            return false;
+        }
+        MarkFlag(shortParamName, longParamName);
+        return true;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(std::string_view shortParamName, std::string_view longParamName = {}) {
+        return TryParse<TValue>({}, shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &&defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        return TryParse(defaultValue, shortParamName, longParamName);
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    std::optional<TValue> TryParse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        TValue result = {defaultValue};
+        ArgMatch match;
+        auto res = ParseValue(result, shortParamName, longParamName, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return {};
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    ArgResult<TValue> Parse(std::string_view shortParamName, std::string_view longParamName = {}) {
+        TValue result = {};
+        ArgMatch match;
+        ArgError error;
+        auto res = ParseValue(result, shortParamName, longParamName, &match, &error);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+            return result;
+        }
+        if (res == kParseResult::OkNotPresent) {
+            return ArgError{res, 0, longParamName.empty() ? shortParamName : longParamName};
+        }
+        return error;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    ArgResult<TValue> Parse(const TValue &defaultValue, std::string_view shortParamName, std::string_view longParamName = {}) {
+        TValue result = {defaultValue};
+        ArgMatch match;
+        ArgError error;
+        auto res = ParseValue(result, shortParamName, longParamName, &match, &error);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+        }
+        if ((res == kParseResult::Ok) || (res == kParseResult::OkNotPresent)) {
+            return result;
+        }
+        return error;
+    }
+
+    // Same as ArgParser::TryParse with a vector, the vector is the only thing allocating
+    template<typename TValue>
+    [[nodiscard]]
+    int TryParse(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}) {
+        typename Scanner::template ArgVectorStore<TValue> store{outValues};
+        // same count as ArgParser, the values following the first one
+        auto nValues = StoreValues<TValue>(store, shortParamName, longParamName);
+        return (nValues > 0) ? (nValues - 1) : 0;
+    }
+
+    // Values of an option into caller provided storage, returns the number of values, 0 if not present and -1 if
+    // a value could not be converted or there are more values than fit
+    template<typename TValue, size_t Extent>
+    [[nodiscard]]
+    int TryParse(std::span<TValue, Extent> outValues, std::string_view shortParamName, std::string_view longParamName = {}) {
+        typename Scanner::template ArgSpanStore<TValue, Extent> store{outValues};
+        return StoreValues<TValue>(store, shortParamName, longParamName);
+    }
+
+    // Parse an argument holding a delimited list, returns the number of values, 0 if not present and -1 on error
+    template<typename TValue>
+    int TryParseList(std::vector<TValue> &outValues, std::string_view shortParamName, std::string_view longParamName = {}, char separator = ',') {
+        typename Scanner::template ArgVectorStore<TValue> store{outValues};
+        return StoreList<TValue>(store, shortParamName, longParamName, separator);
+    }
+
+    // Same as above into caller provided storage, -1 if there are more values than fit as well
+    template<typename TValue, size_t Extent>
+    int TryParseList(std::span<TValue, Extent> outValues, std::string_view shortParamName, std::string_view longParamName = {}, char separator = ',') {
+        typename Scanner::template ArgSpanStore<TValue, Extent> store{outValues};
+        return StoreList<TValue>(store, shortParamName, longParamName, separator);
+    }
+
+    [[nodiscard]]
+    int CountPresence(std::string_view shortParamName, std::string_view longParamName = {}) {
+        int nFound = CountOccurrences(shortParamName, longParamName);
+        if (nFound > 0) {
+            MarkFlag(shortParamName, longParamName);
+        }
+        return nFound;
+    }
+
+    template<typename TValue>
+    [[nodiscard]]
+    int CopyEndArgs(std::vector<TValue> &outValues, bool append = true) const {
+        auto idxStart = IndexOfEndArgs();
+        if (idxStart == args.size()) {
+            return 0;
+        }
+        if (!append) {
+            outValues.clear();
+        }
+        outValues.reserve(outValues.size() + (args.size() - idxStart));
+        for(size_t i=idxStart;i<args.size();i++) {
+            auto res = Scanner::template convert_to<TValue>(args[i]);
+            if (!res.has_value()) {
+                return -1;
+            }
+            outValues.push_back(*res);
+        }
+        return static_cast<int>(args.size() - idxStart);
+    }
+
+    // End arguments into caller provided storage, -1 if a value could not be converted or they don't fit
+    template<typename TValue, size_t Extent>
+    [[nodiscard]]
+    int CopyEndArgs(std::span<TValue, Extent> outValues) const {
+        auto idxStart = IndexOfEndArgs();
+        if ((args.size() - idxStart) > outValues.size()) {
+            return -1;
+        }
+        for(size_t i=idxStart;i<args.size();i++) {
+            if (!Scanner::ConvertElement(std::string_view(args[i]), outValues[i - idxStart])) {
+                return -1;
+            }
+        }
+        return static_cast<int>(args.size() - idxStart);
+    }
+
+    // Arguments no query has used, see ArgParser::Unconsumed
+    int Unconsumed(std::vector<std::string_view> &outArgs) const {
+        return ForEachUnconsumed([&outArgs](std::string_view arg) {
+            outArgs.push_back(arg);
+            return true;
+        });
+    }
+
+    // Same as above into caller provided storage, -1 if there are more than fit
+    int Unconsumed(std::span<std::string_view> outArgs) const {
+        size_t nStored = 0;
+        return ForEachUnconsumed([&outArgs, &nStored](std::string_view arg) {
+            if (nStored >= outArgs.size()) {
+                return false;
+            }
+            outArgs[nStored++] = arg;
+            return true;
+        });
+    }
+
+protected:
+    using typename Scanner::ArgMatch;
+    using Scanner::args;
+    using Scanner::stoparg;
+    using Scanner::diagnostics;
+    using Scanner::shortFlags;
+    using Scanner::ParsePresent;
+    using Scanner::ParseValue;
+    using Scanner::CountOccurrences;
+    using Scanner::ClearConsumed;
+    using Scanner::MarkOption;
+    using Scanner::MarkFlag;
+    using Scanner::ForEachUnconsumed;
+    using Scanner::IndexOfEndArgs;
+
+    // Values up to the next option into 'store' and marked as consumed, returns the number of values, 0 if not
+    // present and -1 on a value which could not be converted or stored
+    template<typename TValue, typename TStore>
+    int StoreValues(TStore &store, std::string_view shortParamName, std::string_view longParamName) {
+        int nValues = 0;
+        ArgMatch match;
+        auto res = this->template ParseValues<TValue>(store, nValues, shortParamName, longParamName, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, static_cast<size_t>(nValues), shortParamName, longParamName);
+            return nValues;
+        }
+        return (res == kParseResult::OkNotPresent) ? 0 : -1;
+    }
+
+    template<typename TValue, typename TStore>
+    int StoreList(TStore &store, std::string_view shortParamName, std::string_view longParamName, char separator) {
+        int nValues = 0;
+        ArgMatch match;
+        auto res = this->template ParseList<TValue>(store, nValues, shortParamName, longParamName, separator, &match);
+        if (res == kParseResult::Ok) {
+            MarkOption(match, 1, shortParamName, longParamName);
+            return nValues;
+        }
+        return (res == kParseResult::OkNotPresent) ? 0 : -1;
+    }
+
+private:
+    bool bValid = true;
+};
+
+//
+// Declarative binding of a config struct
+//
+// Register member pointers with their option names and fill the whole struct in a single pass over argv.
+// Same rules as the individual queries; first occurrence of a value wins, flags are set on presence and counters
+// are counted like CountPresence. Fields for options not present keep their current value.
+//
+// Use like:
+//      ArgBinder<AppConfig> binder(argParser);
+//      binder.Count(&AppConfig::verboseLevel, "-v")
+//            .Value(&AppConfig::someInteger, "-n", "--number")
+//            .Flag(&AppConfig::bFeature, "-f", "--feature");
+//      auto result = binder.Bind(config);
+//
+template<typename TConfig>
+class ArgBinder {
+public:
+    struct Result {
+        ArgParser::kParseResult result = ArgParser::kParseResult::Ok;
+        // number of fields assigned from argv
+        size_t nBound = 0;
+        // argv index and option name of the argument causing an error
+        size_t idxError = 0;
+        std::string_view option = {};
+
+        [[nodiscard]]
+        bool IsOk() const {
+            return result == ArgParser::kParseResult::Ok;
+        }
+    };
+public:
+    ArgBinder() = delete;
+    explicit ArgBinder(ArgParser &parser) : argParser(parser) {
+    }
+    virtual ~ArgBinder() = default;
+
+    // Option with a value converted to the type of the field
+    template<typename TValue>
+    ArgBinder &Value(TValue TConfig::*member, std::string_view shortParamName, std::string_view longParamName = {}) {
+        auto cbConvert = [member](TConfig &config, std::string_view value) -> bool {
+            auto res = ArgParser::convert_to<TValue>(value);
+            if (!res.has_value()) {
+                return false;
+            }
+            config.*member = std::move(*res);
+            return true;
+        };
+        AddField(kFieldType::Value, shortParamName, longParamName, cbConvert, {});
+        return *this;
+    }
+
+    // Flag, set to true if present
+    ArgBinder &Flag(bool TConfig::*member, std::string_view shortParamName, std::string_view longParamName = {}) {
+        auto cbFlag = [member](TConfig &config, int) {
+            config.*member = true;
+        };
+        AddField(kFieldType::Flag, shortParamName, longParamName, {}, cbFlag);
+        return *this;
+    }
+
+    // Counter, set to the number of times the option is present (like a verbose level)
+    ArgBinder &Count(int TConfig::*member, std::string_view shortParamName, std::string_view longParamName = {}) {
+        auto cbCount = [member](TConfig &config, int nCount) {
+            config.*member = nCount;
+        };
+        AddField(kFieldType::Count, shortParamName, longParamName, {}, cbCount);
+        return *this;
+    }
+
+    // Walk argv once and assign all registered fields
+    Result Bind(TConfig &config) {
+        Result result;
+        std::vector<int> counts(fields.size(), 0);
+        std::vector<bool> assigned(fields.size(), false);
+
+        auto args = argParser.args;
+        for(size_t i=0;i<args.size();++i) {
+            std::string_view arg = args[i];
+            if (arg == argParser.stoparg) {
+                break;
+            }
+            if (!ArgParser::IsValidArgument(arg)) {
+                continue;
+            }
+
+            // Complete name ('-a' or '--name'), or a long name with an attached value ('--name=value')
+            auto name = ArgParser::OptionName(arg);
+            auto idxField = Lookup(name);
+            if (idxField >= 0) {
+                argParser.MarkConsumed(i);
+                if (fields[idxField].type == kFieldType::Count) {
+                    // CountPresence counts the long name once and the letters of anything else
+                    if (arg.starts_with("--")) {
+                        counts[idxField]++;
+                        continue;
+                    }
+                } else {
+                    std::optional<std::string_view> attached;
+                    if (name.length() < arg.length()) {
+                        attached = arg.substr(name.length() + 1);
+                    }
+                    if (!Assign(config, result, assigned, args, i, static_cast<size_t>(idxField), attached)) {
+                        return result;
+                    }
+                    continue;
+                }
+            }
+
+            if (arg.starts_with("--")) continue;
+
+            // Letters of a short name or bundle ('-abc'), values are taken from the next argument - unless the value
+            // directly follows a single letter option ('-n45')
+            size_t idxArg = i;
+            for(size_t j=1;j<arg.length();j++) {
+                auto idxBundled = bundled[static_cast<uint8_t>(arg[j])];
+                if (idxBundled < 0) continue;
+                argParser.consumedLetters.set(static_cast<uint8_t>(arg[j]));
+                if (fields[idxBundled].type == kFieldType::Count) {
+                    counts[idxBundled]++;
+                    continue;
+                }
+                if ((j == 1) && (fields[idxBundled].type == kFieldType::Value) && (arg.length() > 2)) {
+                    argParser.MarkConsumed(i);
+                    if (!Assign(config, result, assigned, args, idxArg, static_cast<size_t>(idxBundled), arg.substr(2))) {
+                        return result;
+                    }
+                    break;
+                }
+                if (!Assign(config, result, assigned, args, idxArg, static_cast<size_t>(idxBundled))) {
+                    return result;
+                }
+            }
+            i = idxArg;
+        }
+
+        for(size_t i=0;i<fields.size();i++) {
+            if ((fields[i].type == kFieldType::Count) && (counts[i] > 0)) {
+                fields[i].cbSet(config, counts[i]);
+                result.nBound++;
+            }
+        }
+        return result;
+    }
+
+protected:
+    enum class kFieldType {
+        Value,
+        Flag,
+        Count,
+    };
+
+    struct Field {
+        kFieldType type;
+        std::string shortName;
+        std::string longName;
+        std::function<bool(TConfig &, std::string_view)> cbConvert;
+        std::function<void(TConfig &, int)> cbSet;
+    };
+
+    void AddField(kFieldType type, std::string_view shortParamName, std::string_view longParamName,
+                  std::function<bool(TConfig &, std::string_view)> cbConvert, std::function<void(TConfig &, int)> cbSet) {
+        auto idxField = static_cast<int>(fields.size());
+        fields.push_back({type, std::string(shortParamName), std::string(longParamName), std::move(cbConvert), std::move(cbSet)});
+        if (!shortParamName.empty()) {
+            names.emplace(shortParamName, idxField);
+        }
+        if (!longParamName.empty()) {
+            names.emplace(longParamName, idxField);
+        }
+        // Single letter short names are matched in bundles
+        if ((shortParamName.length() == 2) && (shortParamName[0] == '-') && (shortParamName[1] != '-')) {
+            bundled[static_cast<uint8_t>(shortParamName[1])] = idxField;
+        }
+    }
+
+    [[nodiscard]]
+    int Lookup(std::string_view arg) const {
+        auto it = names.find(arg);
+        return (it == names.end()) ? -1 : it->second;
+    }
+
+    // Allow lookup with string_view without creating a string
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    bool Assign(TConfig &config, Result &result, std::vector<bool> &assigned, std::span<const char *> args, size_t &idxArg, size_t idxField, std::optional<std::string_view> attached = {}) {
+        auto &field = fields[idxField];
+        if (field.type == kFieldType::Flag) {
+            if (!assigned[idxField]) {
+                field.cbSet(config, 1);
+                assigned[idxField] = true;
+                result.nBound++;
+            }
+            return true;
+        }
+
+        std::string_view value;
+        auto idxOption = idxArg;
+        if (attached.has_value()) {
+            value = *attached;
+        } else {
+            if ((idxArg + 1) >= args.size()) {
+                result.result = ArgParser::kParseResult::ErrMissingArg;
+                result.idxError = idxArg;
+                result.option = field.longName.empty() ? field.shortName : field.longName;
+                argParser.Report(result.result, idxOption, idxArg, field.shortName);
+                return false;
+            }
+            ++idxArg;
+            argParser.MarkConsumed(idxArg);
+            value = args[idxArg];
+        }
+        // first occurrence wins - but the value is still consumed
+        if (assigned[idxField]) {
+            return true;
+        }
+        if (!field.cbConvert(config, value)) {
+            result.result = ArgParser::kParseResult::ErrArgTypeError;
+            result.idxError = idxArg;
+            result.option = field.longName.empty() ? field.shortName : field.longName;
+            argParser.Report(result.result, idxOption, idxArg, field.shortName);
+            return false;
+        }
+        assigned[idxField] = true;
+        result.nBound++;
+        return true;
+    }
+
+private:
+    ArgParser &argParser;
+    std::vector<Field> fields;
+    std::unordered_map<std::string, int, StringHash, std::equal_to<>> names;
+    std::array<int, 256> bundled = MakeBundled();
+
+    static constexpr std::array<int, 256> MakeBundled() {
+        std::array<int, 256> table = {};
+        table.fill(-1);
+        return table;
+    }
+};
+
+//
+// Bounded edit distance (Levenshtein) of a fixed pattern against many texts, used for 'did you mean' suggestions.
+// Patterns up to 64 characters use the bit-parallel algorithm of Myers in the formulation of Hyyrö; one column of
+// the distance matrix is a handful of word operations no matter how long the pattern is. A text whose length alone
+// puts it out of bounds is skipped, and a text is abandoned as soon as the rest of it can't bring the distance back
+// within the bound. Longer patterns fall back to the classic two-row dynamic program.
+//
+class ArgEditDistance {
+public:
+    explicit ArgEditDistance(std::string_view strPattern) : pattern(strPattern) {
+        if (pattern.length() <= 64) {
+            for(size_t i=0;i<pattern.length();i++) {
+                peq[static_cast<uint8_t>(pattern[i])] |= uint64_t(1) << i;
+            }
+        }
+    }
+
+    // Distance between the pattern and 'text', or 'maxDistance + 1' if it is above 'maxDistance'
+    [[nodiscard]]
+    size_t Distance(std::string_view text, size_t maxDistance) const {
+        size_t m = pattern.length();
+        size_t n = text.length();
+        if (((m > n) ? (m - n) : (n - m)) > maxDistance) {
+            return maxDistance + 1;
+        }
+        if (m == 0) {
+            return n;
+        }
+        if (m > 64) {
+            return DistanceClassic(text, maxDistance);
+        }
+
+        uint64_t pv = (m == 64) ? ~uint64_t(0) : ((uint64_t(1) << m) - 1);
+        uint64_t mv = 0;
+        uint64_t last = uint64_t(1) << (m - 1);
+        size_t score = m;
+        for(size_t j=0;j<n;j++) {
+            uint64_t eq = peq[static_cast<uint8_t>(text[j])];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last) {
+                score++;
+            } else if (mh & last) {
+                score--;
+            }
+            // the first row is the distance to an empty pattern, it grows by one per column
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            // every remaining column lowers the score by one at most
+            if (score > maxDistance + (n - j - 1)) {
+                return maxDistance + 1;
+            }
+        }
+        return (score > maxDistance) ? maxDistance + 1 : score;
+    }
+
+protected:
+    [[nodiscard]]
+    size_t DistanceClassic(std::string_view text, size_t maxDistance) const {
+        std::vector<size_t> prev(pattern.length() + 1), cur(pattern.length() + 1);
+        for(size_t i=0;i<prev.size();i++) {
+            prev[i] = i;
+        }
+        for(size_t j=0;j<text.length();j++) {
+            cur[0] = j + 1;
+            size_t best = cur[0];
+            for(size_t i=0;i<pattern.length();i++) {
+                size_t cost = (pattern[i] == text[j]) ? 0 : 1;
+                cur[i + 1] = std::min({prev[i] + cost, prev[i + 1] + 1, cur[i] + 1});
+                best = std::min(best, cur[i + 1]);
+            }
+            // no cell of the column within bound, no path can get back
+            if (best > maxDistance) {
+                return maxDistance + 1;
+            }
+            std::swap(prev, cur);
+        }
+        return std::min(prev.back(), maxDistance + 1);
+    }
+
+private:
+    std::string_view pattern;
+    // positions of each character in the pattern
+    std::array<uint64_t, 256> peq = {};
+};
+
+//
+// Shell completion
+//
+// Register the option names of a tool and answer a completion request from the shell, like:
+//      tool --__complete tool -v --thr
+// with the names starting with the last word, one per line. The names are kept in a sorted index, so the candidates
+// are a binary search and a walk over the matching range. Names registered in sorted order (like generated ones)
+// are not sorted again. The same rules as for the ArgParser decide whether the last word is an option at all; a word
+// after the stop condition or the value of an option (the next argument, unless attached like '--name=value' or
+// '-nVALUE') gets no candidates.
+//
+// Use like:
+//      ArgCompletion completion;
+//      completion.Flag("-v", "--verbose").Value("-t", "--threads");
+//      if (completion.Run(argc, argv)) {
+//          return 0;
+//      }
+//
+class ArgCompletion {
+public:
+    static constexpr std::string_view kCompleteOption = "--__complete";
+public:
+    ArgCompletion() = default;
+    virtual ~ArgCompletion() = default;
+
+    // Option without a value
+    ArgCompletion &Flag(std::string_view shortParamName, std::string_view longParamName = {}) {
+        AddName(shortParamName, false);
+        AddName(longParamName, false);
+        return *this;
+    }
+
+    // Option taking a value
+    ArgCompletion &Value(std::string_view shortParamName, std::string_view longParamName = {}) {
+        AddName(shortParamName, true);
+        AddName(longParamName, true);
+        return *this;
+    }
+
+    void SetStopCondition(std::string_view stopArg) {
+        stoparg = stopArg;
+    }
+
+    // Candidates for the last word of a command line, 'words[0]' is the program name. The candidates point into
+    // the completion and are valid until the next name is registered. Returns the number of candidates added.
+    size_t Complete(std::span<const char *const> words, std::vector<std::string_view> &outCandidates) {
+        if (words.size() < 2) {
+            return 0;
+        }
+        bool bValue = false;
+        for(size_t i=1;i<words.size()-1;i++) {
+            std::string_view arg = words[i];
+            if (bValue) {
+                bValue = false;
+                continue;
+            }
+            if (!stoparg.empty() && (arg == stoparg)) {
+                return 0;
+            }
+            if (ArgParser::IsValidArgument(arg)) {
+                bValue = TakesNextValue(arg);
+            }
+        }
+        std::string_view prefix = words.back();
+        if (bValue || !ArgParser::IsValidArgument(prefix) || (prefix.starts_with("--") && (prefix.find('=') != std::string_view::npos))) {
+            return 0;
+        }
+
+        BuildIndex();
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix, [this](uint32_t idxName, std::string_view value) {
+            return Name(idxName) < value;
+        });
+        size_t nFound = 0;
+        for(;(it != sorted.end()) && Name(*it).starts_with(prefix);++it) {
+            outCandidates.push_back(Name(*it));
+            nFound++;
+        }
+        return nFound;
+    }
+
+    // Completion mode, if argv[1] is '--__complete' the candidates for the rest of argv are written to 'out' one
+    // per line and true is returned - the tool should exit then.
+    bool Run(size_t argc, const char **argv, FILE *out = stdout) {
+        if ((argc < 2) || (argv[1] != kCompleteOption)) {
+            return false;
+        }
+        std::vector<std::string_view> candidates;
+        Complete(std::span<const char *const>(argv + 2, argc - 2), candidates);
+        for(auto candidate : candidates) {
+            fprintf(out, "%.*s\n", (int)candidate.size(), candidate.data());
+        }
+        return true;
+    }
+
+    // Registered names within 'maxDistance' edits of 'arg', like an unknown option reported by Unconsumed, closest
+    // first. Meant for the error path, nothing is done up front. Returns the number of names added.
+    size_t Suggest(std::string_view arg, std::vector<std::string_view> &outNames, size_t maxDistance = 2) {
+        // compare the option itself, not an attached value
+        arg = ArgParser::OptionName(arg);
+        ArgEditDistance editDistance(arg);
+        BuildIndex();
+        std::vector<std::pair<size_t, uint32_t>> found;
+        for(auto idxName : sorted) {
+            auto distance = editDistance.Distance(Name(idxName), maxDistance);
+            if (distance <= maxDistance) {
+                found.emplace_back(distance, idxName);
+            }
+        }
+        // the index is sorted, equally close names stay in name order
+        std::stable_sort(found.begin(), found.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        for(auto &[distance, idxName] : found) {
+            outNames.push_back(Name(idxName));
+        }
+        return found.size();
+    }
+
+    [[nodiscard]]
+    size_t Count() const {
+        return names.size();
+    }
+
+protected:
+    // A registered name is a slice of 'text', the text is appended to so names are kept as offsets
+    struct NameRef {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        bool bValue = false;
+    };
+
+    void AddName(std::string_view name, bool bValue) {
+        if (name.empty()) {
+            return;
+        }
+        names.push_back({static_cast<uint32_t>(text.size()), static_cast<uint32_t>(name.length()), bValue});
+        text.append(name);
+        // single letter options with a value, for bundles like '-vn <value>'
+        if (bValue && (name.length() == 2) && (name[0] == '-') && (name[1] != '-')) {
+            valueLetters.set(static_cast<uint8_t>(name[1]));
+        }
+    }
+
+    [[nodiscard]]
+    std::string_view Name(uint32_t idxName) const {
+        return {text.data() + names[idxName].offset, names[idxName].length};
+    }
+
+    void BuildIndex() {
+        if (sorted.size() == names.size()) {
+            return;
+        }
+        sorted.resize(names.size());
+        for(uint32_t i=0;i<sorted.size();i++) {
+            sorted[i] = i;
+        }
+        auto cbLess = [this](uint32_t a, uint32_t b) { return Name(a) < Name(b); };
+        // Generated names are mostly registered in order, mixed with a few hand written ones. Such input is a few
+        // sorted runs which are merged, anything else is sorted.
+        std::vector<size_t> runs = {0};
+        for(size_t i=1;i<sorted.size();i++) {
+            if (cbLess(sorted[i], sorted[i - 1])) {
+                runs.push_back(i);
+                if (runs.size() > kMaxMergedRuns) {
+                    std::sort(sorted.begin(), sorted.end(), cbLess);
+                    return;
+                }
+            }
+        }
+        runs.push_back(sorted.size());
+        std::vector<size_t> merged;
+        while(runs.size() > 2) {
+            merged.clear();
+            size_t k = 0;
+            for(;(k + 2) < runs.size();k += 2) {
+                std::inplace_merge(sorted.begin() + runs[k], sorted.begin() + runs[k + 1], sorted.begin() + runs[k + 2], cbLess);
+                merged.push_back(runs[k]);
+            }
+            merged.insert(merged.end(), runs.begin() + k, runs.end());
+            std::swap(runs, merged);
+        }
+    }
+
+    [[nodiscard]]
+    const NameRef *Find(std::string_view name) {
+        BuildIndex();
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), name, [this](uint32_t idxName, std::string_view value) {
+            return Name(idxName) < value;
+        });
+        if ((it == sorted.end()) || (Name(*it) != name)) {
+            return nullptr;
+        }
+        return &names[*it];
+    }
+
+    // Whether the argument after 'arg' is its value, same as ArgParser::MatchOption
+    [[nodiscard]]
+    bool TakesNextValue(std::string_view arg) {
+        auto name = Find(arg);
+        if (name != nullptr) {
+            return name->bValue;
+        }
+        // attached values ('--name=value') and long names are never bundles
+        if (arg.starts_with("--") || (arg.length() < 2)) {
+            return false;
+        }
+        // '-nVALUE', the value follows a single letter option directly
+        if (valueLetters.test(static_cast<uint8_t>(arg[1]))) {
+            return false;
+        }
+        // a bundle with an option taking a value, the value is the next argument
+        for(size_t j=2;j<arg.length();j++) {
+            if (valueLetters.test(static_cast<uint8_t>(arg[j]))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // more sorted runs than this and the names are sorted instead of merged
+    static constexpr size_t kMaxMergedRuns = 64;
+
+    std::string text;
+    std::vector<NameRef> names;
+    // index into 'names', ordered by name
+    std::vector<uint32_t> sorted;
+    std::bitset<256> valueLetters;
+    std::string stoparg = {};
+};
+
+//
+// Compile time option schema
+//
+// When all options are known at compile time the schema generates a perfect hash over all names and fills a typed
+// result in a single pass over argv. Options of type 'bool' are flags (presence), anything else expects a value.
+// Same rules as the ArgParser; first occurrence wins, short flags can be bundled ('-abc') and the value of an
+// option is the next argument.
+//
+// Use like:
+//      using Schema = ArgSchema<ArgOption<"-n", "--number", int>,
+//                               ArgOption<"-v", "--verbose", bool>,
+//                               ArgOption<"-i", "--input", std::string>>;
+//      auto result = Schema::Parse(argc, argv);
+//      int number = result.Get<"--number">().value_or(42);
+//
+
+// String literal usable as template argument
+template<size_t N>
+struct ArgName {
+    constexpr ArgName(const char (&str)[N]) {
+        std::copy_n(str, N, value);
+    }
+    [[nodiscard]]
+    constexpr std::string_view View() const {
+        return {value, N-1};
+    }
+    char value[N] = {};
+};
+
+template<ArgName ShortName, ArgName LongName, typename TValue>
+struct ArgOption {
+    using value_type = TValue;
+    static constexpr std::string_view shortName = ShortName.View();
+    static constexpr std::string_view longName = LongName.View();
+};
+
+template<typename... TOptions>
+class ArgSchema {
+public:
+    static constexpr size_t nOptions = sizeof...(TOptions);
+
+    struct Result {
+        std::tuple<std::optional<typename TOptions::value_type>...> values;
+        ArgParser::kParseResult result = ArgParser::kParseResult::Ok;
+        // argv index of the argument causing an error
+        size_t idxError = 0;
+
+        [[nodiscard]]
+        bool IsOk() const {
+            return result == ArgParser::kParseResult::Ok;
+        }
+
+        template<ArgName Name>
+        [[nodiscard]]
+        auto &Get() {
+            return std::get<IndexOf(Name.View())>(values);
+        }
+        template<ArgName Name>
+        [[nodiscard]]
+        const auto &Get() const {
+            return std::get<IndexOf(Name.View())>(values);
+        }
+    };
+
+    [[nodiscard]]
+    static Result Parse(size_t argc, const char **argv, std::string_view stopArg = {}) {
+        Result result;
+        std::span<const char *> args{argv, argc};
+        for(size_t i=0;i<args.size();++i) {
+            std::string_view arg = args[i];
+            if (arg == stopArg) {
+                break;
+            }
+            if (!ArgParser::IsValidArgument(arg)) {
+                continue;
+            }
+
+            // complete name, or a long name with an attached value ('--name=value')
+            auto name = ArgParser::OptionName(arg);
+            int idxOption = Lookup(name);
+            if (idxOption >= 0) {
+                std::optional<std::string_view> attached;
+                if (name.length() < arg.length()) {
+                    attached = arg.substr(name.length() + 1);
+                }
+                if (!Dispatch(result, args, i, static_cast<size_t>(idxOption), attached)) {
+                    return result;
+                }
+                continue;
+            }
+
+            // long names are never bundles
+            if (arg.starts_with("--")) continue;
+
+            // bundled short names ('-abc'), the value for an option embedded like this is the next argument - unless
+            // the value directly follows a single letter option ('-n45')
+            size_t idxArg = i;
+            for(size_t j=1;j<arg.length();j++) {
+                auto idxBundled = schema.bundled[static_cast<uint8_t>(arg[j])];
+                if (idxBundled < 0) continue;
+                if ((j == 1) && !isFlag[idxBundled] && (arg.length() > 2)) {
+                    if (!Dispatch(result, args, idxArg, static_cast<size_t>(idxBundled), arg.substr(2))) {
+                        return result;
+                    }
+                    break;
+                }
+                if (!Dispatch(result, args, idxArg, static_cast<size_t>(idxBundled))) {
+                    return result;
+                }
+            }
+            i = idxArg;
+        }
+        return result;
+    }
+
+    // Register all options of the schema for shell completion
+    static void Register(ArgCompletion &completion) {
+        for(size_t i=0;i<nOptions;i++) {
+            if (isFlag[i]) {
+                completion.Flag(shortNames[i], longNames[i]);
+            } else {
+                completion.Value(shortNames[i], longNames[i]);
+            }
+        }
+    }
+
+protected:
+    static constexpr std::array<std::string_view, nOptions> shortNames = { TOptions::shortName... };
+    static constexpr std::array<std::string_view, nOptions> longNames = { TOptions::longName... };
+    static constexpr std::array<bool, nOptions> isFlag = { std::is_same_v<typename TOptions::value_type, bool>... };
+
+    static consteval size_t IndexOf(std::string_view name) {
+        for(size_t i=0;i<nOptions;i++) {
+            if ((shortNames[i] == name) || (longNames[i] == name)) {
+                return i;
+            }
+        }
+        // Not a constant expression => compile error, the name is not part of the schema
+        throw "ArgSchema: unknown option name";
+    }
+
+    static constexpr uint64_t Hash(uint64_t seed, std::string_view name) {
+        // FNV-1a, seeded
+        uint64_t h = 14695981039346656037ull ^ seed;
+        for(auto ch : name) {
+            h ^= static_cast<uint8_t>(ch);
+            h *= 1099511628211ull;
+        }
+        return h ^ (h >> 29);
+    }
+
+    static constexpr size_t TableSize() {
+        size_t n = 8;
+        while(n < nOptions * 4) n <<= 1;
+        return n;
+    }
+
+    struct Tables {
+        uint64_t seed = 0;
+        // option index for each hash slot and which of the names (0 - short, 1 - long) occupies it
+        std::array<int16_t, TableSize()> slots = {};
+        std::array<uint8_t, TableSize()> isLong = {};
+        // option index for single letter short names, used for bundles
+        std::array<int16_t, 256> bundled = {};
+    };
+
+    // Search for a seed that maps every name to its own slot
+    static consteval Tables BuildTables() {
+        for(size_t i=0;i<nOptions;i++) {
+            for(size_t j=0;j<nOptions;j++) {
+                if ((i != j) && !shortNames[i].empty() && ((shortNames[i] == shortNames[j]) || (shortNames[i] == longNames[j]))) {
+                    throw "ArgSchema: duplicate option name";
+                }
+                if ((i != j) && !longNames[i].empty() && (longNames[i] == longNames[j])) {
+                    throw "ArgSchema: duplicate option name";
+                }
+            }
+        }
+
+        Tables tables;
+        constexpr size_t mask = TableSize() - 1;
+        for(uint64_t seed = 0;;seed++) {
+            tables.slots.fill(-1);
+            bool bCollision = false;
+            for(size_t i=0;(i<nOptions) && !bCollision;i++) {
+                for(int l=0;l<2;l++) {
+                    auto name = (l == 0) ? shortNames[i] : longNames[i];
+                    if (name.empty()) continue;
+                    auto pos = Hash(seed, name) & mask;
+                    if (tables.slots[pos] >= 0) {
+                        bCollision = true;
+                        break;
+                    }
+                    tables.slots[pos] = static_cast<int16_t>(i);
+                    tables.isLong[pos] = static_cast<uint8_t>(l);
+                }
+            }
+            if (!bCollision) {
+                tables.seed = seed;
+                break;
+            }
+        }
+
+        tables.bundled.fill(-1);
+        for(size_t i=0;i<nOptions;i++) {
+            if ((shortNames[i].length() == 2) && (shortNames[i][0] == '-') && (shortNames[i][1] != '-')) {
+                tables.bundled[static_cast<uint8_t>(shortNames[i][1])] = static_cast<int16_t>(i);
+            }
+        }
+        return tables;
+    }
+
+    static constexpr Tables schema = BuildTables();
+
+    [[nodiscard]]
+    static int Lookup(std::string_view arg) {
+        auto pos = Hash(schema.seed, arg) & (TableSize() - 1);
+        auto idxOption = schema.slots[pos];
+        if (idxOption < 0) {
+            return -1;
+        }
+        auto name = schema.isLong[pos] ? longNames[idxOption] : shortNames[idxOption];
+        return (name == arg) ? idxOption : -1;
+    }
+
+    // Dispatch the option at runtime index to the compile time tuple element
+    static bool Dispatch(Result &result, std::span<const char *> args, size_t &idxArg, size_t idxOption, std::optional<std::string_view> attached = {}) {
+        bool bOk = true;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((I == idxOption ? (bOk = Assign<I>(result, args, idxArg, attached)) : false), ...);
+        }(std::index_sequence_for<TOptions...>{});
+        return bOk;
+    }
+
+    template<size_t I>
+    static bool Assign(Result &result, std::span<const char *> args, size_t &idxArg, std::optional<std::string_view> attached) {
+        using TValue = typename std::tuple_element_t<I, std::tuple<TOptions...>>::value_type;
+        auto &value = std::get<I>(result.values);
+
+        if constexpr (std::is_same_v<TValue, bool>) {
+            value = true;
+            return true;
+        } else {
+            std::string_view argValue;
+            if (attached.has_value()) {
+                argValue = *attached;
+            } else {
+                if ((idxArg + 1) >= args.size()) {
+                    result.result = ArgParser::kParseResult::ErrMissingArg;
+                    result.idxError = idxArg;
+                    return false;
+                }
+                argValue = args[++idxArg];
+            }
+            // first occurrence wins - but the value is still consumed
+            if (value.has_value()) {
+                return true;
+            }
+            value = ArgParser::convert_to<TValue>(argValue);
+            if (!value.has_value()) {
+                result.result = ArgParser::kParseResult::ErrArgTypeError;
+                result.idxError = idxArg;
+                return false;
+            }
+            return true;
+        }
+    }
+};
+
+//
+// Subcommand dispatch for git style tools, like: 'tool [global options] <command> [command options]'
+//
+// The command names are known at compile time and looked up through a trie built at compile time, one step per
+// character until the remaining candidates are down to a single command which is then compared in one go.
+// The command is the first argument before the stop condition which is neither an option nor consumed by an earlier
+// query - query global options taking a value before dispatching, so their values aren't taken for the command.
+// Each handler gets a parser over the slice of argv starting at its command (see ArgParser::Subcommand), nothing is
+// copied. The stop condition applies per level; the command is only searched before the stop condition of the parser
+// it is dispatched from, and the handler's parser inherits it but can change it without affecting the parent.
+// Handlers can dispatch the next level the same way.
+//
+// Use like:
+//      using Commands = ArgSubcommands<"add", "commit", "remote">;
+//      ArgParser argParser(argc, argv);
+//      bool bVerbose = argParser.IsPresent("-v", "--verbose");
+//      auto exitCode = Commands::Dispatch(argParser,
+//                                         [](ArgParser &args) { return CmdAdd(args); },
+//                                         [](ArgParser &args) { return CmdCommit(args); },
+//                                         [](ArgParser &args) { return CmdRemote(args); });
+//      if (!exitCode.has_value()) { ... no or unknown command ... }
+//
+template<ArgName... Names>
+class ArgSubcommands {
+public:
+    static constexpr size_t nCommands = sizeof...(Names);
+    static_assert(nCommands > 0, "ArgSubcommands: no commands");
+
+    struct Match {
+        // index of the command in 'Names', -1 if there is no command or the argument is not one of them
+        int idxCommand = -1;
+        // argv index of the argument taken as the command, argc if there is none
+        size_t idxArg = 0;
+
+        [[nodiscard]]
+        bool IsValid() const {
+            return idxCommand >= 0;
+        }
+    };
+
+    // Index of a command in 'Names', compile error if it is not one of them
+    template<ArgName Name>
+    [[nodiscard]]
+    static consteval int IndexOf() {
+        for(size_t i=0;i<nCommands;i++) {
+            if (names[i] == Name.View()) {
+                return static_cast<int>(i);
+            }
+        }
+        throw "ArgSubcommands: unknown command";
+    }
+
+    // Index of the command, -1 if 'name' is not a command
+    [[nodiscard]]
+    static int Lookup(std::string_view name) {
+        uint32_t node = 0;
+        for(size_t i=0;i<name.length();i++) {
+            auto idxUnique = trie.unique[node];
+            if (idxUnique >= 0) {
+                return (names[idxUnique].substr(i) == name.substr(i)) ? idxUnique : -1;
+            }
+            auto ch = static_cast<uint8_t>(name[i]);
+            auto idxEdge = trie.firstEdge[node];
+            auto idxEnd = trie.firstEdge[node + 1];
+            while((idxEdge < idxEnd) && (trie.edgeChars[idxEdge] < ch)) {
+                idxEdge++;
+            }
+            if ((idxEdge == idxEnd) || (trie.edgeChars[idxEdge] != ch)) {
+                return -1;
+            }
+            // the child reached through edge 'n' is node 'n + 1'
+            node = idxEdge + 1;
+        }
+        return trie.command[node];
+    }
+
+    [[nodiscard]]
+    static Match Find(const ArgParser &argParser) {
+        Match match;
+        match.idxArg = argParser.args.size();
+        for(size_t i=1;i<argParser.args.size();i++) {
+            std::string_view arg = argParser.args[i];
+            if (arg == argParser.stoparg) {
+                break;
+            }
+            if (ArgParser::IsValidArgument(arg) || argParser.IsConsumed(i)) {
+                continue;
+            }
+            match.idxArg = i;
+            match.idxCommand = Lookup(arg);
+            break;
+        }
+        return match;
+    }
+
+    // Calls the handler of the command, one handler per command in the order of 'Names'. Each handler is called with
+    // a parser over its slice of argv and returns the exit code. Returns nothing if there is no or an unknown command,
+    // use Find to tell them apart. The command argument is marked as consumed in 'argParser'.
+    template<typename... THandlers>
+    static std::optional<int> Dispatch(ArgParser &argParser, THandlers &&... handlers) {
+        static_assert(sizeof...(THandlers) == nCommands, "ArgSubcommands: one handler per command");
+        static_assert((std::is_invocable_r_v<int, THandlers, ArgParser &> && ...), "ArgSubcommands: handlers are 'int (ArgParser &)'");
+
+        auto match = Find(argParser);
+        if (!match.IsValid()) {
+            return {};
+        }
+        argParser.MarkConsumed(match.idxArg);
+        auto subParser = argParser.Subcommand(match.idxArg);
+        auto handlerRefs = std::forward_as_tuple(handlers...);
+        int exitCode = 0;
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((I == static_cast<size_t>(match.idxCommand) ? (exitCode = std::invoke(std::get<I>(handlerRefs), subParser), true) : false), ...);
+        }(std::index_sequence_for<THandlers...>{});
+        return exitCode;
+    }
+
+protected:
+    static constexpr std::array<std::string_view, nCommands> names = { Names.View()... };
+
+    static constexpr size_t MaxNodes() {
+        size_t n = 1;
+        for(auto name : names) {
+            n += name.length();
+        }
+        return n;
+    }
+
+    // Nodes are numbered breadth first, so the children of a node are consecutive and the edges can be stored in the
+    // same order - edge 'n' leads to node 'n + 1' and the edges of node 'i' are [firstEdge[i], firstEdge[i + 1]).
+    struct Trie {
+        std::array<uint32_t, MaxNodes() + 1> firstEdge = {};
+        // sorted per node
+        std::array<uint8_t, MaxNodes()> edgeChars = {};
+        // command ending at the node, or -1
+        std::array<int32_t, MaxNodes()> command = {};
+        // the only command below the node, or -1
+        std::array<int32_t, MaxNodes()> unique = {};
+    };
+
+    static consteval Trie BuildTrie() {
+        for(size_t i=0;i<nCommands;i++) {
+            if (names[i].empty()) {
+                throw "ArgSubcommands: empty command name";
+            }
+            for(size_t j=i+1;j<nCommands;j++) {
+                if (names[i] == names[j]) {
+                    throw "ArgSubcommands: duplicate command name";
+                }
+            }
+        }
+
+        // a node is the prefix of length 'depth' of the command 'prefixOf'
+        struct Prefix {
+            size_t prefixOf = 0;
+            size_t depth = 0;
+        };
+        std::array<Prefix, MaxNodes()> nodes = {};
+        size_t nNodes = 1;
+
+        Trie trie;
+        for(size_t node=0;node<nNodes;node++) {
+            auto prefix = names[nodes[node].prefixOf].substr(0, nodes[node].depth);
+            trie.firstEdge[node] = static_cast<uint32_t>(nNodes - 1);
+            trie.command[node] = -1;
+            trie.unique[node] = -1;
+            size_t nBelow = 0;
+            for(size_t i=0;i<nCommands;i++) {
+                if (!names[i].starts_with(prefix)) {
+                    continue;
+                }
+                nBelow++;
+                trie.unique[node] = static_cast<int32_t>(i);
+                if (names[i].length() == prefix.length()) {
+                    trie.command[node] = static_cast<int32_t>(i);
+                    continue;
+                }
+                // insert the child in order of its character, unless we have it already
+                auto ch = static_cast<uint8_t>(names[i][prefix.length()]);
+                auto idxEdge = trie.firstEdge[node];
+                while((idxEdge < nNodes - 1) && (trie.edgeChars[idxEdge] < ch)) {
+                    idxEdge++;
+                }
+                if ((idxEdge < nNodes - 1) && (trie.edgeChars[idxEdge] == ch)) {
+                    continue;
+                }
+                for(size_t idxMove = nNodes - 1;idxMove > idxEdge;idxMove--) {
+                    trie.edgeChars[idxMove] = trie.edgeChars[idxMove - 1];
+                    nodes[idxMove + 1] = nodes[idxMove];
+                }
+                trie.edgeChars[idxEdge] = ch;
+                nodes[idxEdge + 1] = {i, prefix.length() + 1};
+                nNodes++;
+            }
+            if (nBelow != 1) {
+                trie.unique[node] = -1;
+            }
+        }
+        trie.firstEdge[nNodes] = static_cast<uint32_t>(nNodes - 1);
+        return trie;
+    }
+
+    static constexpr Trie trie = BuildTrie();
 };
 
 #endif
\ No newline at end of file
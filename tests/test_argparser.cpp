@@ -1,58 +1,97 @@
 #include "ArgParser.h"
 #include <testinterface.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+//
+// The classic cases run against both ArgParser and the heap free StaticArgParser, they must behave the same
+//
+using TestStaticParser = StaticArgParser<8, 16>;
+
+static int WithEachParser(ITesting *t, int (*caseDynamic)(ITesting *), int (*caseStatic)(ITesting *)) {
+    int res = caseDynamic(t);
+    if (res != kTR_Pass) {
+        return res;
+    }
+    return caseStatic(t);
+}
 
 extern "C" int test_argparser(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_simple(ITesting *t) {
+template<typename TParser>
+static int CaseSimple(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-h",
             NULL,
     };
-    ArgParser argParser(2,argv);
+    TParser argParser(2,argv);
     TR_ASSERT(t, argParser.IsPresent("-h"));
 
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_simple2(ITesting *t) {
+extern "C" int test_argparser_simple(ITesting *t) {
+    return WithEachParser(t, CaseSimple<ArgParser>, CaseSimple<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseSimple2(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-h",
             NULL,
     };
-    ArgParser argParser(2,argv);
+    TParser argParser(2,argv);
     TR_ASSERT(t, argParser.IsPresent("-h","--help"));
 
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_integer_nodefault(ITesting *t) {
+extern "C" int test_argparser_simple2(ITesting *t) {
+    return WithEachParser(t, CaseSimple2<ArgParser>, CaseSimple2<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseIntegerNodefault(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-i",
             "45",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
-    TR_ASSERT(t, argParser.TryParse<int>("-i","--integer") == 45);
+    TR_ASSERT(t, argParser.template TryParse<int>("-i","--integer") == 45);
     // this is not be present so we should return the default
-    TR_ASSERT(t, argParser.TryParse<int>(60, "-u","--integer") == 60);
+    TR_ASSERT(t, argParser.template TryParse<int>(60, "-u","--integer") == 60);
 
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_integer_short(ITesting *t) {
+extern "C" int test_argparser_integer_nodefault(ITesting *t) {
+    return WithEachParser(t, CaseIntegerNodefault<ArgParser>, CaseIntegerNodefault<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseIntegerShort(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-i",
             "45",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(60, "-i","--integer") == 45);
     // this is not be present so we should return the default
@@ -61,15 +100,20 @@ extern "C" int test_argparser_integer_short(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_integer_short(ITesting *t) {
+    return WithEachParser(t, CaseIntegerShort<ArgParser>, CaseIntegerShort<TestStaticParser>);
+}
+
 // same as 'short' but using the long name instead of short name
-extern "C" int test_argparser_integer_long(ITesting *t) {
+template<typename TParser>
+static int CaseIntegerLong(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "--integer",
             "45",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(60, "-i","--integer") == 45);
     // this is not be present so we should return the default
@@ -78,14 +122,19 @@ extern "C" int test_argparser_integer_long(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_string_short(ITesting *t) {
+extern "C" int test_argparser_integer_long(ITesting *t) {
+    return WithEachParser(t, CaseIntegerLong<ArgParser>, CaseIntegerLong<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseStringShort(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-n",
             "SomeName",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(std::string("DefaultName"), "-n","--name") == "SomeName");
     // this should not be present so we should return the default
@@ -94,15 +143,20 @@ extern "C" int test_argparser_string_short(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_string_short(ITesting *t) {
+    return WithEachParser(t, CaseStringShort<ArgParser>, CaseStringShort<TestStaticParser>);
+}
+
 // same as 'short' but using the long name instead of short name
-extern "C" int test_argparser_string_long(ITesting *t) {
+template<typename TParser>
+static int CaseStringLong(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "--name",
             "SomeName",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(std::string("DefaultName"), "-n","--name") == "SomeName");
     // this should not be present so we should return the default
@@ -111,14 +165,19 @@ extern "C" int test_argparser_string_long(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_float_short(ITesting *t) {
+extern "C" int test_argparser_string_long(ITesting *t) {
+    return WithEachParser(t, CaseStringLong<ArgParser>, CaseStringLong<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseFloatShort(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-f",
             "12.3",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(45.6, "-f","--float") == 12.3);
     // this should not be present so we should return the default
@@ -127,15 +186,20 @@ extern "C" int test_argparser_float_short(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_float_short(ITesting *t) {
+    return WithEachParser(t, CaseFloatShort<ArgParser>, CaseFloatShort<TestStaticParser>);
+}
+
 // same as 'short' but using the long name instead of short name
-extern "C" int test_argparser_float_long(ITesting *t) {
+template<typename TParser>
+static int CaseFloatLong(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "--float",
             "12.3",
             NULL,
     };
-    ArgParser argParser(3,argv);
+    TParser argParser(3,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.TryParse(45.6, "-f","--float") == 12.3);
     // this should not be present so we should return the default
@@ -144,14 +208,19 @@ extern "C" int test_argparser_float_long(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_float_long(ITesting *t) {
+    return WithEachParser(t, CaseFloatLong<ArgParser>, CaseFloatLong<TestStaticParser>);
+}
 
-extern "C" int test_argparser_single_in_middle(ITesting *t) {
+
+template<typename TParser>
+static int CaseSingleInMiddle(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "-abc",
             NULL,
     };
-    ArgParser argParser(2,argv);
+    TParser argParser(2,argv);
     // this is present, so we should grab it
     TR_ASSERT(t, argParser.IsPresent("-b"));
     // this should is not be present so we should return the default
@@ -160,14 +229,19 @@ extern "C" int test_argparser_single_in_middle(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_wrong_argc(ITesting *t) {
+extern "C" int test_argparser_single_in_middle(ITesting *t) {
+    return WithEachParser(t, CaseSingleInMiddle<ArgParser>, CaseSingleInMiddle<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseWrongArgc(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "--name",
             "SomeName",
             NULL,
     };
-    ArgParser argParser(2,argv);    // to few arguments here
+    TParser argParser(2,argv);    // to few arguments here
 
     // this should fail - note: test will pass but an error msg will be sent to stderr
     TR_ASSERT(t, !argParser.TryParse(std::string("default"), "-n", "--name"));
@@ -175,7 +249,12 @@ extern "C" int test_argparser_wrong_argc(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_catchmany(ITesting *t) {
+extern "C" int test_argparser_wrong_argc(ITesting *t) {
+    return WithEachParser(t, CaseWrongArgc<ArgParser>, CaseWrongArgc<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCatchmany(ITesting *t) {
     const char *argv[]= {
             "prgname.exe",
             "--input",
@@ -186,7 +265,7 @@ extern "C" int test_argparser_catchmany(ITesting *t) {
             "other",
             NULL,
     };
-    ArgParser argParser(7,argv);
+    TParser argParser(7,argv);
 
     // this should fail - note: test will pass but an error msg will be sent to stderr
     std::vector<std::string> names;
@@ -197,13 +276,18 @@ extern "C" int test_argparser_catchmany(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_count_simple(ITesting *t) {
+extern "C" int test_argparser_catchmany(ITesting *t) {
+    return WithEachParser(t, CaseCatchmany<ArgParser>, CaseCatchmany<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCountSimple(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "-vvv",
             NULL,
     };
-    ArgParser argParser(2,argv_simple);
+    TParser argParser(2,argv_simple);
 
     // Count the presence of 'v'
     auto num = argParser.CountPresence("-v");
@@ -213,7 +297,12 @@ extern "C" int test_argparser_count_simple(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_count_complex(ITesting *t) {
+extern "C" int test_argparser_count_simple(ITesting *t) {
+    return WithEachParser(t, CaseCountSimple<ArgParser>, CaseCountSimple<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCountComplex(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "-aFv",
@@ -221,7 +310,7 @@ extern "C" int test_argparser_count_complex(ITesting *t) {
             "-dvK",
             NULL,
     };
-    ArgParser argParser(4,argv_simple);
+    TParser argParser(4,argv_simple);
 
     // Count the presence of 'v' across all arguments
     auto num = argParser.CountPresence("-v");
@@ -231,7 +320,12 @@ extern "C" int test_argparser_count_complex(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_count_complex2(ITesting *t) {
+extern "C" int test_argparser_count_complex(ITesting *t) {
+    return WithEachParser(t, CaseCountComplex<ArgParser>, CaseCountComplex<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCountComplex2(ITesting *t) {
     const char *argv_simple[]= {
         "prgname.exe",
         "-aFv",
@@ -239,7 +333,7 @@ extern "C" int test_argparser_count_complex2(ITesting *t) {
         "-dvK",
         NULL,
 };
-    ArgParser argParser(4,argv_simple);
+    TParser argParser(4,argv_simple);
 
     // Count the presence of 'v' across all arguments
     auto num = argParser.CountPresence("-v");
@@ -249,7 +343,12 @@ extern "C" int test_argparser_count_complex2(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_copyend_simple(ITesting *t) {
+extern "C" int test_argparser_count_complex2(ITesting *t) {
+    return WithEachParser(t, CaseCountComplex2<ArgParser>, CaseCountComplex2<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCopyendSimple(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "file1",
@@ -257,7 +356,7 @@ extern "C" int test_argparser_copyend_simple(ITesting *t) {
             "file3",
             NULL,
     };
-    ArgParser argParser(4,argv_simple);
+    TParser argParser(4,argv_simple);
 
     // Count the presence of 'v' across all arguments
     std::vector<std::string> filenames;
@@ -271,7 +370,12 @@ extern "C" int test_argparser_copyend_simple(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_copyend_complex(ITesting *t) {
+extern "C" int test_argparser_copyend_simple(ITesting *t) {
+    return WithEachParser(t, CaseCopyendSimple<ArgParser>, CaseCopyendSimple<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCopyendComplex(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "-abf",
@@ -281,7 +385,7 @@ extern "C" int test_argparser_copyend_complex(ITesting *t) {
             "file4",
             NULL,
     };
-    ArgParser argParser(6,argv_simple);
+    TParser argParser(6,argv_simple);
 
     // Count the presence of 'v' across all arguments
     std::vector<std::string> filenames;
@@ -295,7 +399,12 @@ extern "C" int test_argparser_copyend_complex(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_copyend_complex2(ITesting *t) {
+extern "C" int test_argparser_copyend_complex(ITesting *t) {
+    return WithEachParser(t, CaseCopyendComplex<ArgParser>, CaseCopyendComplex<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCopyendComplex2(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "-i",               // note: that -i takes an argument '-i <file1>'
@@ -306,7 +415,7 @@ extern "C" int test_argparser_copyend_complex2(ITesting *t) {
             "file4",
             NULL,
     };
-    ArgParser argParser(7,argv_simple);
+    TParser argParser(7,argv_simple);
 
     // Count the presence of 'v' across all arguments
     std::vector<std::string> filenames;
@@ -320,8 +429,13 @@ extern "C" int test_argparser_copyend_complex2(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_copyend_complex2(ITesting *t) {
+    return WithEachParser(t, CaseCopyendComplex2<ArgParser>, CaseCopyendComplex2<TestStaticParser>);
+}
+
 // this semi-supported, a helper exists to verify this type of argument parsing
-extern "C" int test_argparser_copyend_complex3(ITesting *t) {
+template<typename TParser>
+static int CaseCopyendComplex3(ITesting *t) {
     const char *argv_simple[]= {
             "prgname.exe",
             "-i",               // note: that -i takes an argument '-i <file1>'
@@ -331,7 +445,7 @@ extern "C" int test_argparser_copyend_complex3(ITesting *t) {
             "output3",
             NULL,
     };
-    ArgParser argParser(6,argv_simple);
+    TParser argParser(6,argv_simple);
 
     std::string input = "dummy";
     input = *argParser.TryParse(input, "-i");
@@ -354,14 +468,19 @@ extern "C" int test_argparser_copyend_complex3(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_copyend_complex4(ITesting *t) {
+extern "C" int test_argparser_copyend_complex3(ITesting *t) {
+    return WithEachParser(t, CaseCopyendComplex3<ArgParser>, CaseCopyendComplex3<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCopyendComplex4(ITesting *t) {
     const char *argv_simple[]= {
         "prgname.exe",
         "-i",               // note: that -i takes an argument '-i <file1>'
         "input1",           // when doing 'copyend' this will also be copied...
         NULL,
 };
-    ArgParser argParser(3,argv_simple);
+    TParser argParser(3,argv_simple);
 
     std::string input = "dummy";
     input = *argParser.TryParse(input, "-i");
@@ -383,7 +502,12 @@ extern "C" int test_argparser_copyend_complex4(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_copyend_complex5(ITesting *t) {
+extern "C" int test_argparser_copyend_complex4(ITesting *t) {
+    return WithEachParser(t, CaseCopyendComplex4<ArgParser>, CaseCopyendComplex4<TestStaticParser>);
+}
+
+template<typename TParser>
+static int CaseCopyendComplex5(ITesting *t) {
     const char *argv_simple[]= {
         "prgname.exe",
         "-i",               // note: that -i takes an argument '-i <file1>'
@@ -391,7 +515,7 @@ extern "C" int test_argparser_copyend_complex5(ITesting *t) {
         "output1",           // when doing 'copyend' this will also be copied...
         NULL,
     };
-    ArgParser argParser(4,argv_simple);
+    TParser argParser(4,argv_simple);
 
     std::string input = "dummy";
     input = *argParser.TryParse(input, "-i");
@@ -413,6 +537,10 @@ extern "C" int test_argparser_copyend_complex5(ITesting *t) {
     return kTR_Pass;
 }
 
+extern "C" int test_argparser_copyend_complex5(ITesting *t) {
+    return WithEachParser(t, CaseCopyendComplex5<ArgParser>, CaseCopyendComplex5<TestStaticParser>);
+}
+
 
 extern "C" int test_argparser_copyallafter(ITesting *t) {
     const char *argv_simple[]= {
@@ -435,7 +563,8 @@ extern "C" int test_argparser_copyallafter(ITesting *t) {
     return kTR_Pass;
 }
 
-extern "C" int test_argparser_stopcond(ITesting *t) {
+template<typename TParser>
+static int CaseStopcond(ITesting *t) {
     const char *argv_simple[]= {
         "prgname.exe",
         "-v",               // note: that -i takes an argument '-i <file1>'
@@ -445,7 +574,7 @@ extern "C" int test_argparser_stopcond(ITesting *t) {
         "-v",           // when doing 'copyend' this will also be copied...
         NULL,
     };
-    ArgParser argParser(6,argv_simple);
+    TParser argParser(6,argv_simple);
     // Before stop condition is set we should see both
     auto num_v = argParser.CountPresence("-v");
     TR_ASSERT(t, num_v == 2)
@@ -459,3 +588,1935 @@ extern "C" int test_argparser_stopcond(ITesting *t) {
 
     return kTR_Pass;
 }
+
+extern "C" int test_argparser_stopcond(ITesting *t) {
+    return WithEachParser(t, CaseStopcond<ArgParser>, CaseStopcond<TestStaticParser>);
+}
+
+extern "C" int test_argparser_index(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-aFv",
+        "--number",
+        "45",
+        "-vbc",
+        "--name",
+        "SomeName",
+        "-i",
+        "12",
+        NULL,
+    };
+    ArgParser argParser(9,argv_simple);
+    argParser.BuildIndex();
+
+    TR_ASSERT(t, argParser.IsPresent("-F"));
+    TR_ASSERT(t, argParser.IsPresent("-c"));
+    TR_ASSERT(t, !argParser.IsPresent("-u", "--unknown"));
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 45);
+    TR_ASSERT(t, argParser.TryParse(0, "-i", "--integer") == 12);
+    TR_ASSERT(t, argParser.TryParse(std::string("DefaultName"), "-s", "--name") == "SomeName");
+    TR_ASSERT(t, argParser.TryParse(60, "-u", "--unteger") == 60);
+    TR_ASSERT(t, argParser.CountPresence("-v") == 2);
+    TR_ASSERT(t, argParser.CountPresence("-x", "--name") == 1);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_index_stopcond(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-v",
+        "-i",
+        "input1",
+        "++",
+        "-v",
+        "-o",
+        "output1",
+        NULL,
+    };
+    ArgParser argParser(8,argv_simple);
+    argParser.BuildIndex();
+    TR_ASSERT(t, argParser.CountPresence("-v") == 2);
+    TR_ASSERT(t, argParser.IsPresent("-o"));
+
+    // changing the stop condition rebuilds the index
+    argParser.SetStopCondition("++");
+    TR_ASSERT(t, argParser.CountPresence("-v") == 1);
+    TR_ASSERT(t, !argParser.IsPresent("-o"));
+    TR_ASSERT(t, argParser.TryParse(std::string("dummy"), "-i") == "input1");
+
+    return kTR_Pass;
+}
+
+//
+// Count heap allocations through a replaced operator new, used to verify the query API doesn't allocate. All forms
+// are replaced so new/delete pairs always match.
+//
+static std::atomic<size_t> glb_nAllocations = 0;
+
+// Every form of operator new ends up here, and every operator delete in CountedFree
+static void *CountedAlloc(size_t sz, size_t alignment = 0) {
+    glb_nAllocations++;
+    if (sz == 0) {
+        sz = 1;
+    }
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (sz + alignment - 1) / alignment * alignment);
+    }
+    return std::malloc(sz);
+}
+static void *CountedAllocOrThrow(size_t sz, size_t alignment = 0) {
+    if (void *ptr = CountedAlloc(sz, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+// Kept out of line: once a replaced operator delete is inlined next to a std::allocator, gcc sees the std::free of a
+// pointer from operator new and warns about a mismatch (-Wmismatched-new-delete)
+[[gnu::noinline]] static void CountedFree(void *ptr) noexcept {
+    std::free(ptr);
+}
+void *operator new(size_t sz) {
+    return CountedAllocOrThrow(sz);
+}
+void *operator new[](size_t sz) {
+    return CountedAllocOrThrow(sz);
+}
+void *operator new(size_t sz, std::align_val_t al) {
+    return CountedAllocOrThrow(sz, static_cast<size_t>(al));
+}
+void *operator new[](size_t sz, std::align_val_t al) {
+    return CountedAllocOrThrow(sz, static_cast<size_t>(al));
+}
+void *operator new(size_t sz, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz);
+}
+void *operator new[](size_t sz, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz);
+}
+void *operator new(size_t sz, std::align_val_t al, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz, static_cast<size_t>(al));
+}
+void *operator new[](size_t sz, std::align_val_t al, const std::nothrow_t &) noexcept {
+    return CountedAlloc(sz, static_cast<size_t>(al));
+}
+void operator delete(void *ptr) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr) noexcept {
+    CountedFree(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+    CountedFree(ptr);
+}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    CountedFree(ptr);
+}
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    CountedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    CountedFree(ptr);
+}
+
+extern "C" int test_argparser_noalloc(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-vvx",
+        "--a_rather_long_option_name_beyond_sso",
+        "45",
+        "--ratio",
+        "0.5",
+        "--enable",
+        "true",
+        "-n",
+        "SomeName",
+        "--",
+        "end1",
+        NULL,
+    };
+    // construction included, the short flags and the consumed state are kept in the parser for a short argv
+    auto nBefore = glb_nAllocations.load();
+    ArgParser argParser(12,argv_simple);
+    argParser.SetStopCondition("--");
+    TR_ASSERT(t, argParser.IsPresent("-x", "--extended_option_name_beyond_sso"));
+    TR_ASSERT(t, !argParser.IsPresent("-q", "--quiet_option_name_beyond_sso"));
+    TR_ASSERT(t, argParser.TryParse(0, "-a", "--a_rather_long_option_name_beyond_sso") == 45);
+    TR_ASSERT(t, argParser.TryParse<double>("-r", "--ratio") == 0.5);
+    TR_ASSERT(t, argParser.TryParse(false, "-e", "--enable") == true);
+    TR_ASSERT(t, argParser.TryParse(std::string_view("default"), "-n", "--name") == "SomeName");
+    TR_ASSERT(t, argParser.CountPresence("-v", "--verbose_option_name_beyond_sso") == 2);
+    TR_ASSERT(t, !argParser.IsLastArgument("-n", "--name"));
+    TR_ASSERT(t, glb_nAllocations == nBefore);
+
+    // beyond 64 arguments the bitmap is allocated by the constructor and Reset, queries still don't allocate
+    std::vector<const char *> argv_long(argv_simple, argv_simple + 12);
+    argv_long.insert(argv_long.end(), 112, "file.c");
+    ArgParser longParser(argv_long.size(), argv_long.data());
+    longParser.SetStopCondition("--");
+    longParser.Reset(argv_long.size(), argv_long.data());
+    nBefore = glb_nAllocations.load();
+    TR_ASSERT(t, longParser.IsPresent("-x", "--extended_option_name_beyond_sso"));
+    TR_ASSERT(t, longParser.TryParse(0, "-a", "--a_rather_long_option_name_beyond_sso") == 45);
+    TR_ASSERT(t, longParser.TryParse(std::string_view("default"), "-n", "--name") == "SomeName");
+    TR_ASSERT(t, longParser.CountPresence("-v", "--verbose_option_name_beyond_sso") == 2);
+    TR_ASSERT(t, !longParser.IsPresent("-q", "--quiet_option_name_beyond_sso"));
+    TR_ASSERT(t, glb_nAllocations == nBefore);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_schema(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-vx",
+        "--number",
+        "45",
+        "-i",
+        "input.file",
+        "--ratio",
+        "0.25",
+        "++",
+        "-o",
+        "ignored",
+        NULL,
+    };
+    using Schema = ArgSchema<ArgOption<"-n", "--number", int>,
+                             ArgOption<"-v", "--verbose", bool>,
+                             ArgOption<"-x", "--extended", bool>,
+                             ArgOption<"-q", "--quiet", bool>,
+                             ArgOption<"-i", "--input", std::string>,
+                             ArgOption<"-o", "--output", std::string>,
+                             ArgOption<"", "--ratio", double>>;
+
+    auto result = Schema::Parse(11, argv_simple, "++");
+    TR_ASSERT(t, result.IsOk());
+    TR_ASSERT(t, result.Get<"--number">() == 45);
+    TR_ASSERT(t, result.Get<"-v">() == true);
+    TR_ASSERT(t, result.Get<"--extended">() == true);
+    TR_ASSERT(t, !result.Get<"--quiet">().has_value());
+    TR_ASSERT(t, result.Get<"-i">() == "input.file");
+    TR_ASSERT(t, result.Get<"--ratio">() == 0.25);
+    // beyond the stop condition
+    TR_ASSERT(t, result.Get<"--output">().value_or("output.file") == "output.file");
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_schema_errors(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "--number",
+        "abc",
+        "--name",
+        NULL,
+    };
+    using Schema = ArgSchema<ArgOption<"-n", "--number", int>,
+                             ArgOption<"", "--name", std::string>>;
+
+    auto result = Schema::Parse(4, argv_simple);
+    TR_ASSERT(t, result.result == ArgParser::kParseResult::ErrArgTypeError);
+    TR_ASSERT(t, result.idxError == 2);
+
+    // value missing for the last argument
+    auto resultMissing = Schema::Parse(2, argv_simple);
+    TR_ASSERT(t, resultMissing.result == ArgParser::kParseResult::ErrMissingArg);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_bind(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-vfv",
+        "--number",
+        "45",
+        "-o",
+        "out.file",
+        "--verbose",
+        "-n",
+        "12",
+        NULL,
+    };
+    struct Config {
+        int verboseLevel = 0;
+        int someInteger = 42;
+        bool bFeature = false;
+        bool bOther = false;
+        std::string inputFile = "input.file";
+        std::string outputFile = "output.file";
+    };
+
+    Config config;
+    ArgParser argParser(9,argv_simple);
+    ArgBinder<Config> binder(argParser);
+    binder.Count(&Config::verboseLevel, "-v", "--verbose")
+          .Value(&Config::someInteger, "-n", "--number")
+          .Flag(&Config::bFeature, "-f", "--feature")
+          .Flag(&Config::bOther, "-x", "--other")
+          .Value(&Config::inputFile, "-i", "--input")
+          .Value(&Config::outputFile, "-o", "--output");
+
+    auto res = binder.Bind(config);
+    TR_ASSERT(t, res.IsOk());
+    TR_ASSERT(t, res.nBound == 4);
+    TR_ASSERT(t, config.verboseLevel == argParser.CountPresence("-v", "--verbose"));
+    TR_ASSERT(t, config.someInteger == 45);
+    TR_ASSERT(t, config.bFeature);
+    TR_ASSERT(t, !config.bOther);
+    TR_ASSERT(t, config.inputFile == "input.file");
+    TR_ASSERT(t, config.outputFile == "out.file");
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_bind_error(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "--number",
+        "abc",
+        NULL,
+    };
+    struct Config {
+        int someInteger = 42;
+    };
+
+    Config config;
+    ArgParser argParser(3,argv_simple);
+    ArgBinder<Config> binder(argParser);
+    binder.Value(&Config::someInteger, "-n", "--number");
+
+    auto res = binder.Bind(config);
+    TR_ASSERT(t, res.result == ArgParser::kParseResult::ErrArgTypeError);
+    TR_ASSERT(t, res.idxError == 2);
+    TR_ASSERT(t, res.option == "--number");
+    TR_ASSERT(t, config.someInteger == 42);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_responsefile(ITesting *t) {
+    char filename[] = "/tmp/argparser_rspXXXXXX";
+    int fd = mkstemp(filename);
+    TR_ASSERT(t, fd >= 0);
+    const char content[] = "--number 45\n  -v\t'file with spaces' \"quoted \\\"name\\\"\" esc\\ aped\n-o out.file \"\"";
+    TR_ASSERT(t, write(fd, content, sizeof(content) - 1) == sizeof(content) - 1);
+    close(fd);
+
+    std::string rspArg = std::string("@") + filename;
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-x",
+        rspArg.c_str(),
+        "last",
+        NULL,
+    };
+    ArgParser argParser(4,argv_simple);
+    TR_ASSERT(t, argParser.ExpandResponseFiles());
+
+    // the program name and the arguments from the stop condition on are never expanded
+    const char *argv_kept[]= {
+        rspArg.c_str(),
+        rspArg.c_str(),
+        "--",
+        rspArg.c_str(),
+        NULL,
+    };
+    ArgParser argParserKept(4,argv_kept);
+    argParserKept.SetStopCondition("--");
+    TR_ASSERT(t, argParserKept.ExpandResponseFiles());
+    std::vector<std::string> kept;
+    // argv[0] is still the '@file' argument, followed by the 9 arguments of the file, the stop argument and the
+    // '@file' argument after it
+    TR_ASSERT(t, argParserKept.CopyAllAfter(kept, rspArg) == 11);
+    TR_ASSERT(t, kept[0] == "--number");
+    TR_ASSERT(t, kept[9] == "--");
+    TR_ASSERT(t, kept[10] == rspArg);
+
+    // tokenized once into a zero terminated buffer of its own, the arguments are ready for an argv
+    ArgResponseFile responseFile;
+    TR_ASSERT(t, responseFile.Open(filename));
+    unlink(filename);
+    auto tokens = responseFile.Tokens();
+    TR_ASSERT(t, tokens.size() == 9);
+    TR_ASSERT(t, std::string_view(tokens[0]) == "--number");
+    TR_ASSERT(t, std::string_view(tokens[3]) == "file with spaces");
+    TR_ASSERT(t, std::string_view(tokens[4]) == "quoted \"name\"");
+    TR_ASSERT(t, std::string_view(tokens[5]) == "esc aped");
+    TR_ASSERT(t, std::string_view(tokens[8]).empty());
+
+    TR_ASSERT(t, argParser.IsPresent("-x"));
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 45);
+    TR_ASSERT(t, argParser.TryParse(std::string("dummy"), "-o") == "out.file");
+
+    std::vector<std::string> all;
+    TR_ASSERT(t, argParser.CopyAllAfter(all, "-v") == 7);
+    TR_ASSERT(t, all[0] == "file with spaces");
+    TR_ASSERT(t, all[1] == "quoted \"name\"");
+    TR_ASSERT(t, all[2] == "esc aped");
+    TR_ASSERT(t, all[4] == "out.file");
+    TR_ASSERT(t, all[5].empty());
+    TR_ASSERT(t, all[6] == "last");
+
+    // missing files are reported
+    const char *argv_missing[]= {
+        "prgname.exe",
+        "@/nonexisting/response.file",
+        NULL,
+    };
+    ArgParser argParserMissing(2,argv_missing);
+    TR_ASSERT(t, !argParserMissing.ExpandResponseFiles());
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_values_view(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "--ids",
+        "1",
+        "2",
+        "x3",
+        "-o",
+        "out.file",
+        NULL,
+    };
+    ArgParser argParser(7,argv_simple);
+
+    std::vector<int> ids;
+    int nInvalid = 0;
+    for(auto id : argParser.Values<int>("-i", "--ids")) {
+        if (!id.has_value()) {
+            nInvalid++;
+            continue;
+        }
+        ids.push_back(*id);
+    }
+    TR_ASSERT(t, ids.size() == 2);
+    TR_ASSERT(t, ids[0] == 1 && ids[1] == 2);
+    TR_ASSERT(t, nInvalid == 1);
+
+    // not present gives an empty range
+    auto missing = argParser.Values<std::string_view>("-u", "--unknown");
+    TR_ASSERT(t, missing.begin() == missing.end());
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_endargs_view(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-i",
+        "input1",
+        "output1",
+        "output2",
+        NULL,
+    };
+    ArgParser argParser(5,argv_simple);
+    auto input = argParser.TryParse(std::string("dummy"), "-i");
+    TR_ASSERT(t, input == "input1");
+
+    std::vector<std::string_view> outputs;
+    for(auto name : argParser.EndArgs<std::string_view>()) {
+        outputs.push_back(*name);
+    }
+    TR_ASSERT(t, outputs.size() == 2);
+    TR_ASSERT(t, outputs[0] == "output1");
+
+    // must be the same as CopyEndArgs
+    std::vector<std::string> copied;
+    TR_ASSERT(t, argParser.CopyEndArgs(copied) == 2);
+    TR_ASSERT(t, copied[1] == outputs[1]);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_list(ITesting *t) {
+    std::string ids;
+    for(int i=0;i<100;i++) {
+        ids += std::to_string(i * 1234567 - 1000) + ",";
+    }
+    ids += "-9223372036854775808";
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "--names",
+        "one;two;;three",
+        "--ids",
+        ids.c_str(),
+        "--bad",
+        "1,2,x",
+        "--big",
+        "1,99999999999999999999",
+        NULL,
+    };
+    ArgParser argParser(9,argv_simple);
+
+    std::vector<int64_t> values;
+    TR_ASSERT(t, argParser.TryParseList(values, "-i", "--ids") == 101);
+    TR_ASSERT(t, values[0] == -1000);
+    TR_ASSERT(t, values[99] == 99 * 1234567 - 1000);
+    TR_ASSERT(t, values[100] == INT64_MIN);
+
+    std::vector<std::string_view> names;
+    TR_ASSERT(t, argParser.TryParseList(names, "-n", "--names", ';') == 4);
+    TR_ASSERT(t, names[2].empty());
+    TR_ASSERT(t, names[3] == "three");
+
+    std::vector<int> bad;
+    TR_ASSERT(t, argParser.TryParseList(bad, "", "--bad") == -1);
+    std::vector<uint64_t> big;
+    TR_ASSERT(t, argParser.TryParseList(big, "", "--big") == -1);
+    std::vector<int> none;
+    TR_ASSERT(t, argParser.TryParseList(none, "", "--unknown") == 0);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_snapshot(ITesting *t) {
+    const char *argv_simple[]= {
+        "prgname.exe",
+        "-vv",
+        "--threads",
+        "8",
+        "-i",
+        "input1",
+        "output1",
+        "output2",
+        NULL,
+    };
+    ArgParser argParser(8,argv_simple);
+    TR_ASSERT(t, argParser.TryParse(std::string("dummy"), "-i") == "input1");
+
+    const auto snapshot = argParser.Freeze();
+
+    // query concurrently from several threads, no synchronisation
+    std::atomic<int> nErrors = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<4;i++) {
+        threads.emplace_back([&snapshot, &nErrors]() {
+            for(int j=0;j<1000;j++) {
+                if (snapshot.TryParse(1, "-t", "--threads") != 8) nErrors++;
+                if (!snapshot.IsPresent("-v")) nErrors++;
+                if (snapshot.IsPresent("-x")) nErrors++;
+                if (snapshot.CountPresence("-v") != 2) nErrors++;
+                std::vector<std::string_view> outputs;
+                if (snapshot.CopyEndArgs(outputs) != 2) nErrors++;
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nErrors == 0);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_reset(ITesting *t) {
+    const char *argv_first[]= {
+        "prgname.exe",
+        "-v",
+        "--number",
+        "45",
+        "++",
+        "-x",
+        NULL,
+    };
+    const char *argv_second[]= {
+        "prgname.exe",
+        "--number",
+        "12",
+        "file1",
+        "++",
+        "-v",
+        NULL,
+    };
+    ArgParser argParser(6,argv_first);
+    argParser.SetStopCondition("++");
+    argParser.BuildIndex();
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    TR_ASSERT(t, !argParser.IsPresent("-x"));
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 45);
+
+    // the stop condition is kept, and the index capacity is reused
+    auto nBefore = glb_nAllocations.load();
+    argParser.Reset(6, argv_second);
+    TR_ASSERT(t, !argParser.IsPresent("-v"));
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 12);
+    TR_ASSERT(t, argParser.CountPresence("-v") == 0);
+    TR_ASSERT(t, glb_nAllocations == nBefore);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_cmdline(ITesting *t) {
+    ArgCommandLine cmdLine;
+    TR_ASSERT(t, cmdLine.Tokenize("set   --key 'some value'\t-v \"a \\\"quoted\\\" one\" file\\ name") == 6);
+
+    ArgParser argParser(cmdLine.Argc(), cmdLine.Argv());
+    TR_ASSERT(t, argParser.TryParse(std::string_view{}, "-k", "--key") == "some value");
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    std::vector<std::string_view> endArgs;
+    TR_ASSERT(t, argParser.CopyEndArgs(endArgs) == 2);
+    TR_ASSERT(t, endArgs[0] == "a \"quoted\" one");
+    TR_ASSERT(t, endArgs[1] == "file name");
+
+    // the buffers are reused, no allocations for a shorter command
+    auto nBefore = glb_nAllocations.load();
+    TR_ASSERT(t, cmdLine.Tokenize("get --key other") == 3);
+    argParser.Reset(cmdLine.Argc(), cmdLine.Argv());
+    TR_ASSERT(t, argParser.TryParse(std::string_view{}, "-k", "--key") == "other");
+    TR_ASSERT(t, glb_nAllocations == nBefore);
+
+    TR_ASSERT(t, cmdLine.Tokenize("   ") == 0);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_shortflags(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "-vvxzf",
+        "--verbose",
+        "-v",
+        "file.tar",
+        "--",
+        "-q",
+        NULL,
+    };
+    ArgParser argParser(7,argv);
+    TR_ASSERT(t, argParser.IsPresent("-x"));
+    TR_ASSERT(t, argParser.IsPresent("-z"));
+    TR_ASSERT(t, !argParser.IsPresent("-e"));
+    TR_ASSERT(t, argParser.CountPresence("-v") == 3);
+    TR_ASSERT(t, argParser.CountPresence("-vv") == 3);
+    TR_ASSERT(t, argParser.CountPresence("-v", "--verbose") == 4);
+    // letters of long arguments don't count as short flags
+    TR_ASSERT(t, !argParser.IsPresent("-b"));
+
+    // everything after the stop condition is ignored
+    argParser.SetStopCondition("--");
+    TR_ASSERT(t, !argParser.IsPresent("-q"));
+    argParser.SetStopCondition("file.tar");
+    TR_ASSERT(t, argParser.CountPresence("-f") == 1);
+
+    return kTR_Pass;
+}
+
+template<typename TParser>
+static int CaseUnconsumed(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "-vxq",
+        "--thread",
+        "8",
+        "--input",
+        "in1",
+        "in2",
+        "--verbose",
+        "-o",
+        "output",
+        "--verbose",
+        "end1",
+        "end2",
+        NULL,
+    };
+    TParser argParser(13,argv);
+    TR_ASSERT(t, argParser.IsPresent("-v", "--verbose"));
+    TR_ASSERT(t, argParser.IsPresent("-x"));
+    std::vector<std::string> inputs;
+    TR_ASSERT(t, argParser.TryParse(inputs, "-i", "--input") == 1);
+    TR_ASSERT(t, argParser.TryParse(std::string_view{}, "-o", "--output") == "output");
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 1);
+
+    std::vector<std::string_view> unconsumed;
+    TR_ASSERT(t, argParser.Unconsumed(unconsumed) == 3);
+    // 'q' was never asked for, so the bundle is reported
+    TR_ASSERT(t, unconsumed[0] == "-vxq");
+    TR_ASSERT(t, unconsumed[1] == "--thread");
+    TR_ASSERT(t, unconsumed[2] == "8");
+
+    // end arguments are not reported
+    std::vector<std::string_view> endArgs;
+    TR_ASSERT(t, argParser.CopyEndArgs(endArgs) == 2);
+    TR_ASSERT(t, endArgs[0] == "end1");
+
+    TR_ASSERT(t, argParser.IsPresent("-q"));
+    unconsumed.clear();
+    TR_ASSERT(t, argParser.Unconsumed(unconsumed) == 2);
+
+    // start over
+    argParser.Reset(13, argv);
+    unconsumed.clear();
+    TR_ASSERT(t, argParser.Unconsumed(unconsumed) == 10);
+
+    // nothing from the stop condition on is reported, neither the stop argument nor unknown options after it
+    const char *argvStop[]= {
+        "prgname.exe",
+        "--unknown",
+        "--",
+        "--passed-on",
+        "-z",
+        NULL,
+    };
+    TParser stopParser(5, argvStop);
+    stopParser.SetStopCondition("--");
+    unconsumed.clear();
+    TR_ASSERT(t, stopParser.Unconsumed(unconsumed) == 1);
+    TR_ASSERT(t, unconsumed[0] == "--unknown");
+
+    // flag names may be temporaries, the consumed flags keep their own copy
+    std::vector<std::string> flagArgs = {"prgname.exe"};
+    for(int i=0;i<12;i++) {
+        flagArgs.push_back("--generated_flag_name_" + std::to_string(i));
+    }
+    std::vector<const char *> argvFlags;
+    for(auto &arg : flagArgs) {
+        argvFlags.push_back(arg.c_str());
+    }
+    TParser flagParser(argvFlags.size(), argvFlags.data());
+    for(int i=0;i<12;i++) {
+        TR_ASSERT(t, flagParser.IsPresent("", std::string("--generated_flag_name_") + std::to_string(i)));
+    }
+    unconsumed.clear();
+    TR_ASSERT(t, flagParser.Unconsumed(unconsumed) == 0);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_unconsumed(ITesting *t) {
+    return WithEachParser(t, CaseUnconsumed<ArgParser>, CaseUnconsumed<TestStaticParser>);
+}
+
+extern "C" int test_argparser_accumulate(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "-I",
+        "include",
+        "-D",
+        "NDEBUG",
+        "--include",
+        "/usr/include",
+        "-v",
+        "-D",
+        "VERSION=1.2",
+        "-D",
+        "EMPTY=",
+        "-I",
+        "third_party",
+        "file.c",
+        NULL,
+    };
+    ArgParser argParser(15,argv);
+    std::vector<std::string_view> includes;
+    TR_ASSERT(t, argParser.TryParseAll(includes, "-I", "--include") == 3);
+    TR_ASSERT(t, includes[0] == "include");
+    TR_ASSERT(t, includes[1] == "/usr/include");
+    TR_ASSERT(t, includes[2] == "third_party");
+    // pointing straight into argv
+    TR_ASSERT(t, includes[0].data() == argv[2]);
+
+    std::vector<std::pair<std::string_view, std::string_view>> defines;
+    TR_ASSERT(t, argParser.TryParseMap(defines, "-D", "--define") == 3);
+    TR_ASSERT(t, defines[0].first == "NDEBUG" && defines[0].second.empty());
+    TR_ASSERT(t, defines[1].first == "VERSION" && defines[1].second == "1.2");
+    TR_ASSERT(t, defines[2].first == "EMPTY" && defines[2].second.empty());
+
+    std::vector<int> numbers;
+    TR_ASSERT(t, argParser.TryParseAll(numbers, "-n", "--number") == 0);
+    TR_ASSERT(t, argParser.TryParseAll(numbers, "-I") == -1);
+
+    // the index is skipped on a short argv, same result
+    argParser.BuildIndex();
+    includes.clear();
+    TR_ASSERT(t, argParser.TryParseAll(includes, "-I", "--include") == 3);
+    TR_ASSERT(t, includes[2] == "third_party");
+
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    std::vector<std::string_view> unconsumed;
+    TR_ASSERT(t, argParser.Unconsumed(unconsumed) == 0);
+    std::vector<std::string_view> endArgs;
+    TR_ASSERT(t, argParser.CopyEndArgs(endArgs) == 1);
+
+    // long enough for the index, the definitions come after a file list
+    std::vector<const char *> argvLong = {"prgname.exe"};
+    for(int i=0;i<40;i++) {
+        argvLong.push_back("file.c");
+    }
+    for(auto arg : {"-DNDEBUG", "--define", "VERSION=1.2", "-D", "EMPTY="}) {
+        argvLong.push_back(arg);
+    }
+    ArgParser argParserLong(argvLong.size(), argvLong.data());
+    argParserLong.BuildIndex();
+    defines.clear();
+    TR_ASSERT(t, argParserLong.TryParseMap(defines, "-D", "--define") == 3);
+    TR_ASSERT(t, defines[0].first == "NDEBUG");
+    TR_ASSERT(t, defines[1].first == "VERSION" && defines[1].second == "1.2");
+    TR_ASSERT(t, defines[2].first == "EMPTY" && defines[2].second.empty());
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_attached(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "--threads=8",
+        "-n45",
+        "--name=",
+        "--files=a.txt",
+        "b.txt",
+        "--ids=1,2,3",
+        "-Iinclude",
+        "--include=/usr/include",
+        "-v",
+        "end1",
+        NULL,
+    };
+    ArgParser argParser(11,argv);
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 45);
+    TR_ASSERT(t, argParser.TryParse(std::string_view("default"), "-x", "--name") == "");
+    std::vector<std::string_view> files;
+    TR_ASSERT(t, argParser.TryParse(files, "-f", "--files") == 1);
+    TR_ASSERT(t, files.size() == 2);
+    TR_ASSERT(t, files[0] == "a.txt");
+    // slices of argv, nothing copied
+    TR_ASSERT(t, files[0].data() == argv[4] + 8);
+    std::vector<int> ids;
+    TR_ASSERT(t, argParser.TryParseList(ids, "", "--ids") == 3);
+    std::vector<std::string_view> includes;
+    TR_ASSERT(t, argParser.TryParseAll(includes, "-I", "--include") == 2);
+    TR_ASSERT(t, includes[0] == "include");
+    TR_ASSERT(t, includes[1] == "/usr/include");
+    TR_ASSERT(t, argParser.CountPresence("", "--threads") == 1);
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+
+    // flags don't take attached values, '-n45' is a bundle for them
+    TR_ASSERT(t, argParser.IsPresent("-4"));
+
+    std::vector<std::string_view> unconsumed;
+    TR_ASSERT(t, argParser.Unconsumed(unconsumed) == 0);
+    std::vector<std::string_view> endArgs;
+    TR_ASSERT(t, argParser.CopyEndArgs(endArgs) == 1);
+
+    // Values view with the first value attached
+    int nValues = 0;
+    for(auto file : argParser.Values<std::string_view>("-f", "--files")) {
+        TR_ASSERT(t, file.has_value());
+        nValues++;
+    }
+    TR_ASSERT(t, nValues == 2);
+
+    // the index stores '--name=value' under '--name'
+    argParser.BuildIndex();
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, argParser.TryParse(0, "-n", "--number") == 45);
+    TR_ASSERT(t, argParser.CountPresence("", "--threads") == 1);
+    includes.clear();
+    TR_ASSERT(t, argParser.TryParseAll(includes, "-I", "--include") == 2);
+
+    // schema and binder accept both forms as well
+    using Schema = ArgSchema<ArgOption<"-t", "--threads", int>,
+                             ArgOption<"-n", "--number", int>,
+                             ArgOption<"-v", "--verbose", bool>>;
+    auto result = Schema::Parse(11, argv);
+    TR_ASSERT(t, result.IsOk());
+    TR_ASSERT(t, result.Get<"--threads">() == 8);
+    TR_ASSERT(t, result.Get<"-n">() == 45);
+
+    struct Config {
+        int threads = 1;
+        int number = 0;
+    };
+    Config config;
+    ArgBinder<Config> binder(argParser);
+    binder.Value(&Config::threads, "-t", "--threads")
+          .Value(&Config::number, "-n", "--number");
+    TR_ASSERT(t, binder.Bind(config).IsOk());
+    TR_ASSERT(t, config.threads == 8);
+    TR_ASSERT(t, config.number == 45);
+
+    return kTR_Pass;
+}
+
+// Id which can't be converted throws instead of failing, like a converter allocating or calling into other code
+struct ThrowingId {
+    int value = 0;
+};
+template<>
+struct ArgConverter<ThrowingId> {
+    static std::optional<ThrowingId> Convert(std::string_view sv) {
+        if (sv == "bad") {
+            throw std::runtime_error("bad id");
+        }
+        ThrowingId out;
+        if (ArgNumberParser::ParseInteger(sv.data(), sv.data() + sv.size(), out.value) != std::errc{}) return std::nullopt;
+        return out;
+    }
+};
+
+extern "C" int test_argparser_endargs_parallel(ITesting *t) {
+    // enough end arguments for several chunks
+    std::vector<std::string> strings = {"prgname.exe", "-v"};
+    for(int i=0;i<100000;i++) {
+        strings.push_back(std::to_string(i));
+    }
+    std::vector<const char *> argv;
+    for(auto &str : strings) {
+        argv.push_back(str.c_str());
+    }
+
+    ArgParser argParser(argv.size(), argv.data());
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    std::vector<int> ids = {-1};
+    TR_ASSERT(t, argParser.CopyEndArgsParallel(ids, true, 4) == 100000);
+    TR_ASSERT(t, ids.size() == 100001);
+    TR_ASSERT(t, ids[1] == 0);
+    TR_ASSERT(t, ids[100000] == 99999);
+    std::vector<int> sequential;
+    TR_ASSERT(t, argParser.CopyEndArgs(sequential) == 100000);
+    TR_ASSERT(t, std::equal(sequential.begin(), sequential.end(), ids.begin() + 1));
+
+    // the first error wins, no matter which thread finds it
+    strings[2 + 70000] = "bad";
+    strings[2 + 30000] = "bad";
+    argv[2 + 70000] = strings[2 + 70000].c_str();
+    argv[2 + 30000] = strings[2 + 30000].c_str();
+    ids.clear();
+    TR_ASSERT(t, argParser.CopyEndArgsParallel(ids, false, 4) == -1);
+    TR_ASSERT(t, ids.size() == 30000);
+
+    // a throwing conversion is rethrown on the calling thread after all threads are joined
+    std::vector<ThrowingId> throwingIds = {ThrowingId{-1}};
+    bool bCaught = false;
+    try {
+        (void)argParser.CopyEndArgsParallel(throwingIds, true, 4);
+    } catch(const std::runtime_error &e) {
+        bCaught = (std::string_view(e.what()) == "bad id");
+    }
+    TR_ASSERT(t, bCaught);
+    TR_ASSERT(t, throwingIds.size() == 1);
+
+    return kTR_Pass;
+}
+
+// Fixed size error log for the diagnostics test, the sink must not allocate
+struct DiagnosticsLog {
+    std::array<ArgParser::ArgError, 8> errors;
+    size_t nErrors = 0;
+
+    static void Report(void *context, const ArgParser::ArgError &error) {
+        auto log = static_cast<DiagnosticsLog *>(context);
+        if (log->nErrors < log->errors.size()) {
+            log->errors[log->nErrors] = error;
+        }
+        log->nErrors++;
+    }
+};
+
+extern "C" int test_argparser_diagnostics(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "-n", "abc",
+        "--threads=x",
+        "--list", "1,2,x",
+        "-D", "A=1",
+        "--count", "4",
+        "--input", "a", "b",
+        "-o",
+        NULL,
+    };
+    ArgParser argParser(14, argv);
+
+    // without a sink failures are silent - nothing is written to stderr
+    fflush(stderr);
+    auto fdSaved = dup(2);
+    auto captured = tmpfile();
+    dup2(fileno(captured), 2);
+    TR_ASSERT(t, !argParser.TryParse(0, "-n", "--number").has_value());
+    TR_ASSERT(t, !argParser.TryParse(std::string{}, "-o", "--output").has_value());
+    fflush(stderr);
+    dup2(fdSaved, 2);
+    close(fdSaved);
+    TR_ASSERT(t, ftell(captured) == 0);
+    fclose(captured);
+
+    // the result carries kind, argv index and option name
+    auto number = argParser.Parse(0, "-n", "--number");
+    TR_ASSERT(t, !number.has_value());
+    TR_ASSERT(t, number.error().kind == ArgParser::kParseResult::ErrArgTypeError);
+    TR_ASSERT(t, number.error().idxArg == 2);
+    TR_ASSERT(t, number.error().option == "-n");
+
+    auto threads = argParser.Parse(1, "-t", "--threads");
+    TR_ASSERT(t, !threads);
+    TR_ASSERT(t, threads.error().idxArg == 3);
+    TR_ASSERT(t, threads.error().option == "--threads");
+
+    auto output = argParser.Parse<std::string>("-o", "--output");
+    TR_ASSERT(t, output.error().kind == ArgParser::kParseResult::ErrMissingArg);
+    TR_ASSERT(t, output.error().idxArg == 13);
+
+    auto count = argParser.Parse(1, "-c", "--count");
+    TR_ASSERT(t, count.has_value());
+    TR_ASSERT(t, *count == 4);
+    TR_ASSERT(t, argParser.Parse(8, "-j", "--jobs").value() == 8);
+    auto missing = argParser.Parse<int>("-j", "--jobs");
+    TR_ASSERT(t, missing.error().kind == ArgParser::kParseResult::OkNotPresent);
+    TR_ASSERT(t, missing.value_or(3) == 3);
+    // value() of an error result throws with the error, like std::expected
+    bool bThrown = false;
+    try {
+        (void)number.value();
+    } catch(const ArgParser::ArgBadResultAccess &ex) {
+        bThrown = (ex.error().kind == ArgParser::kParseResult::ErrArgTypeError) && (ex.error().option == "-n");
+    }
+    TR_ASSERT(t, bThrown);
+
+    // every error goes to the sink, also from queries without a result type
+    DiagnosticsLog log;
+    argParser.SetDiagnostics(DiagnosticsLog::Report, &log);
+    std::vector<int> list;
+    list.reserve(8);
+    auto nAllocsBefore = glb_nAllocations.load();
+    TR_ASSERT(t, !argParser.TryParse(0, "-n", "--number").has_value());
+    TR_ASSERT(t, argParser.TryParseList(list, "-l", "--list") == -1);
+    TR_ASSERT(t, glb_nAllocations == nAllocsBefore);
+    std::vector<int> inputs;
+    TR_ASSERT(t, argParser.TryParse(inputs, "-i", "--input") == 0);
+    TR_ASSERT(t, log.nErrors == 3);
+    TR_ASSERT(t, log.errors[0].idxArg == 2);
+    TR_ASSERT(t, log.errors[1].kind == ArgParser::kParseResult::ErrArgTypeError);
+    TR_ASSERT(t, log.errors[1].option == "--list");
+    TR_ASSERT(t, log.errors[1].idxArg == 5);
+    // the first value converting fails, the option is still the one queried
+    TR_ASSERT(t, log.errors[2].idxArg == 11);
+    TR_ASSERT(t, log.errors[2].option == "--input");
+
+    // the binder reports through the sink of its parser
+    struct Config {
+        int count = 0;
+        int threads = 0;
+    };
+    Config config;
+    ArgBinder<Config> binder(argParser);
+    binder.Value(&Config::count, "-c", "--count")
+          .Value(&Config::threads, "-t", "--threads");
+    TR_ASSERT(t, !binder.Bind(config).IsOk());
+    TR_ASSERT(t, log.nErrors == 4);
+    TR_ASSERT(t, log.errors[3].option == "--threads");
+
+    return kTR_Pass;
+}
+
+// User types for the converter test, one through the ArgConverter trait and one through ADL
+namespace testnet {
+    struct Endpoint {
+        std::string_view host;
+        uint16_t port = 0;
+    };
+    static bool ArgFromString(std::string_view sv, Endpoint &out) {
+        auto idx = sv.rfind(':');
+        if ((idx == std::string_view::npos) || (idx == 0)) {
+            return false;
+        }
+        out.host = sv.substr(0, idx);
+        auto port = sv.substr(idx + 1);
+        return ArgNumberParser::ParseInteger(port.data(), port.data() + port.size(), out.port) == std::errc{};
+    }
+}
+
+struct Percentage {
+    int value = 0;
+};
+template<>
+struct ArgConverter<Percentage> {
+    static std::optional<Percentage> Convert(std::string_view sv) {
+        if (!sv.ends_with('%')) return std::nullopt;
+        Percentage out;
+        auto digits = sv.substr(0, sv.size() - 1);
+        if (ArgNumberParser::ParseInteger(digits.data(), digits.data() + digits.size(), out.value) != std::errc{}) return std::nullopt;
+        if ((out.value < 0) || (out.value > 100)) return std::nullopt;
+        return out;
+    }
+};
+
+enum class LogLevel { Debug, Info, Warning };
+template<>
+struct ArgEnumNames<LogLevel> {
+    static constexpr std::pair<std::string_view, LogLevel> names[] = {
+        {"debug", LogLevel::Debug}, {"info", LogLevel::Info}, {"warning", LogLevel::Warning}
+    };
+};
+enum class Mode : uint8_t { A = 1, B = 2 };
+
+extern "C" int test_argparser_converters(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "--cache", "64KiB",
+        "--limit", "2G",
+        "--timeout", "1h30m",
+        "--poll", "250ms",
+        "--level", "warning",
+        "--mode", "2",
+        "--peers", "10.0.0.1:80", "example.org:8080",
+        "--cpu", "75%",
+        "--ratios", "10%,20%,30%",
+        NULL,
+    };
+    ArgParser argParser(20, argv);
+
+    TR_ASSERT(t, argParser.TryParse(ArgByteSize{}, "", "--cache")->bytes == 64 * 1024);
+    TR_ASSERT(t, *argParser.TryParse(ArgByteSize{}, "", "--limit") == (uint64_t(2) << 30));
+    TR_ASSERT(t, *argParser.TryParse(std::chrono::seconds{}, "", "--timeout") == std::chrono::minutes(90));
+    TR_ASSERT(t, *argParser.TryParse(std::chrono::milliseconds{}, "", "--poll") == std::chrono::milliseconds(250));
+    // not representable in whole seconds
+    TR_ASSERT(t, !argParser.TryParse(std::chrono::seconds{}, "", "--poll").has_value());
+    TR_ASSERT(t, argParser.TryParse(std::chrono::duration<double>{}, "", "--poll")->count() == 0.25);
+    TR_ASSERT(t, *argParser.TryParse(LogLevel::Info, "", "--level") == LogLevel::Warning);
+    TR_ASSERT(t, *argParser.TryParse(Mode::A, "", "--mode") == Mode::B);
+    TR_ASSERT(t, argParser.TryParse(Percentage{}, "", "--cpu")->value == 75);
+
+    std::vector<testnet::Endpoint> peers;
+    TR_ASSERT(t, argParser.TryParse(peers, "", "--peers") > 0);
+    TR_ASSERT(t, peers.size() == 2);
+    TR_ASSERT(t, peers[0].host == "10.0.0.1");
+    TR_ASSERT(t, peers[1].port == 8080);
+
+    std::vector<Percentage> ratios;
+    TR_ASSERT(t, argParser.TryParseList(ratios, "", "--ratios") == 3);
+    TR_ASSERT(t, ratios[2].value == 30);
+
+    // converters on their own
+    auto cbSize = [](std::string_view sv) { return ArgConverter<ArgByteSize>::Convert(sv); };
+    TR_ASSERT(t, cbSize("512")->bytes == 512);
+    TR_ASSERT(t, cbSize("512b")->bytes == 512);
+    TR_ASSERT(t, cbSize("4k")->bytes == 4096);
+    TR_ASSERT(t, cbSize("1MB")->bytes == 1024 * 1024);
+    TR_ASSERT(t, cbSize("15E")->bytes == (uint64_t(15) << 60));
+    TR_ASSERT(t, !cbSize("16E").has_value());
+    TR_ASSERT(t, !cbSize("K").has_value());
+    TR_ASSERT(t, !cbSize("4Ki").has_value());
+    TR_ASSERT(t, !cbSize("4KBB").has_value());
+    TR_ASSERT(t, !cbSize("4X").has_value());
+
+    using namespace std::chrono;
+    TR_ASSERT(t, *ArgConverter<nanoseconds>::Convert("1s5ns") == nanoseconds(1000000005));
+    TR_ASSERT(t, *ArgConverter<minutes>::Convert("2d") == hours(48));
+    TR_ASSERT(t, *ArgConverter<seconds>::Convert("-1m") == seconds(-60));
+    TR_ASSERT(t, *ArgConverter<seconds>::Convert("42") == seconds(42));
+    TR_ASSERT(t, *ArgConverter<seconds>::Convert("1min") == seconds(60));
+    TR_ASSERT(t, !ArgConverter<seconds>::Convert("1x").has_value());
+    TR_ASSERT(t, !ArgConverter<seconds>::Convert("h").has_value());
+    TR_ASSERT(t, !ArgConverter<seconds>::Convert("1h30").has_value());
+    TR_ASSERT(t, !ArgConverter<seconds>::Convert("").has_value());
+    TR_ASSERT(t, !ArgConverter<LogLevel>::Convert("verbose").has_value());
+    TR_ASSERT(t, !ArgConverter<Mode>::Convert("x").has_value());
+    testnet::Endpoint endpoint;
+    TR_ASSERT(t, !ArgFromString("nohost", endpoint));
+
+    // schema and binder go through the same converters
+    using Schema = ArgSchema<ArgOption<"", "--timeout", std::chrono::seconds>,
+                             ArgOption<"", "--level", LogLevel>>;
+    auto result = Schema::Parse(20, argv);
+    TR_ASSERT(t, result.IsOk());
+    TR_ASSERT(t, result.Get<"--timeout">() == std::chrono::seconds(5400));
+    TR_ASSERT(t, result.Get<"--level">() == LogLevel::Warning);
+
+    struct Config {
+        ArgByteSize cache;
+        std::chrono::milliseconds poll{};
+    };
+    Config config;
+    ArgBinder<Config> binder(argParser);
+    binder.Value(&Config::cache, "", "--cache")
+          .Value(&Config::poll, "", "--poll");
+    TR_ASSERT(t, binder.Bind(config).IsOk());
+    TR_ASSERT(t, config.cache.bytes == 65536);
+    TR_ASSERT(t, config.poll == std::chrono::milliseconds(250));
+
+    return kTR_Pass;
+}
+
+// Exact decimal of the point halfway between x and its successor, 'nudge' appends one more digit to step above
+// (nudge > 0) or below (nudge < 0) it
+template<typename T>
+static std::string HalfwayString(T x, int nudge) {
+    using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    constexpr int kMantissaBits = (sizeof(T) == 8) ? 52 : 23;
+    constexpr int kBias = (sizeof(T) == 8) ? 1023 : 127;
+    auto bits = std::bit_cast<Bits>(x);
+    uint64_t m = bits & ((Bits(1) << kMantissaBits) - 1);
+    int exp2 = static_cast<int>(bits >> kMantissaBits);
+    int e = 1 - kBias - kMantissaBits;
+    if (exp2 > 0) {
+        m |= uint64_t(1) << kMantissaBits;
+        e = exp2 - kBias - kMantissaBits;
+    }
+    // digits of (2m + 1) * 2^(e - 1), least significant first
+    std::vector<int> digits;
+    for(auto v = 2 * m + 1; v != 0; v /= 10) {
+        digits.push_back(static_cast<int>(v % 10));
+    }
+    auto cbMultiply = [&digits](int factor) {
+        int carry = 0;
+        for(auto &d : digits) {
+            auto v = d * factor + carry;
+            d = v % 10;
+            carry = v / 10;
+        }
+        for(;carry != 0; carry /= 10) {
+            digits.push_back(carry % 10);
+        }
+    };
+    // 2^-k = 5^k * 10^-k
+    int exp10 = 0;
+    for(int i=0;i<(e - 1);i++) cbMultiply(2);
+    for(int i=0;i<(1 - e);i++) cbMultiply(5);
+    if (e < 1) exp10 = e - 1;
+
+    std::string str;
+    for(auto it = digits.rbegin(); it != digits.rend(); ++it) {
+        str.push_back(static_cast<char>('0' + *it));
+    }
+    if (nudge > 0) {
+        str += "1";
+        exp10--;
+    } else if (nudge < 0) {
+        // one ulp of the appended digit below: (digits * 10 - 1)
+        str += "9";
+        exp10--;
+        auto idx = str.size() - 1;
+        while(str[--idx] == '0') str[idx] = '9';
+        str[idx]--;
+    }
+    return str + "e" + std::to_string(exp10);
+}
+
+template<typename T>
+static bool SameAsFromChars(const std::string &str) {
+    T expected = -7, actual = -7;
+    auto r = std::from_chars(str.data(), str.data() + str.size(), expected);
+    auto ecExpected = ((r.ec == std::errc{}) && (r.ptr != str.data() + str.size())) ? std::errc::invalid_argument : r.ec;
+    auto ecActual = ArgNumberParser::ParseFloat(str.data(), str.data() + str.size(), actual);
+    if (ecExpected != ecActual) {
+        printf("Mismatch on '%s': ec %d vs %d\n", str.c_str(), (int)ecExpected, (int)ecActual);
+        return false;
+    }
+    if (ecActual != std::errc{}) {
+        return true;
+    }
+    if (std::isnan(expected) && std::isnan(actual) && (std::signbit(expected) == std::signbit(actual))) {
+        return true;
+    }
+    if (memcmp(&expected, &actual, sizeof(T)) != 0) {
+        printf("Mismatch on '%s': %.17g vs %.17g\n", str.c_str(), (double)expected, (double)actual);
+        return false;
+    }
+    return true;
+}
+
+extern "C" int test_argparser_number_differential(ITesting *t) {
+    // the in-house parsers must agree bit for bit with std::from_chars
+    std::vector<std::string> fixed = {
+        "0", "-0", "0.0", "00000.000", "1", "-1", "1.", ".5", "-.5", ".", "-", "", "+1", "1e", "1e+", "1e-", "1e+5",
+        "1E5", "1e-5", "0x10", "1.5x", " 1", "1 ", "1..2", "1e5.5", "inf", "-Infinity", "INF", "infx", "infinit",
+        "nan", "-NaN", "nan()", "nan(abc_1)", "nan(", "nan(a-b)", "nanx", "0e999999999", "1e999999999", "1e-999999999",
+        "1e308", "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "2e308",
+        "2.2250738585072011e-308", "2.2250738585072012e-308", "2.2250738585072014e-308", "4.9406564584124654e-324",
+        "2.4703282292062327e-324", "2.4703282292062328e-324", "3e-324", "2e-324", "1e-400",
+        "3.4028235e38", "3.4028236e38", "1.17549435e-38", "1.4e-45", "7e-46", "1e-46", "1e39",
+        "9007199254740993", "9007199254740993.0000000000000000000001", "9007199254740992.9999999999999999999999",
+        "9007199254740993.0000000000000000000000", "1e23", "8.98846567431158e307", "123456789012345678901234567890",
+        "0.000000000000000000000000000000000000000000001234567890123456789012345678901234567890e50",
+        "18446744073709551615", "18446744073709551616", "9999999999999999999", "99999999999999999999",
+        "1.00000005960464477550", "1.0000000596046447755", "1.00000005960464477539062499999999999999",
+        "16777217", "16777217.000000000000000000001", "33554435", "7.038531e-26",
+    };
+    for(auto &str : fixed) {
+        TR_ASSERT(t, SameAsFromChars<double>(str));
+        TR_ASSERT(t, SameAsFromChars<float>(str));
+    }
+    // a thousand digits, far beyond what either path looks at directly
+    std::string longDigits = "1" + std::string(998, '0') + "1";
+    TR_ASSERT(t, SameAsFromChars<double>(longDigits + "e-999"));
+    TR_ASSERT(t, SameAsFromChars<double>("0." + std::string(700, '0') + longDigits + "e400"));
+
+    std::mt19937_64 rng(1234);
+    auto cbRandomDouble = [&rng]() {
+        double x;
+        do {
+            x = std::bit_cast<double>(rng());
+        } while(!std::isfinite(x));
+        return x;
+    };
+    auto cbRandomFloat = [&rng]() {
+        float x;
+        do {
+            x = std::bit_cast<float>(static_cast<uint32_t>(rng()));
+        } while(!std::isfinite(x));
+        return x;
+    };
+
+    // shortest round trip and arbitrary precision renderings of random values
+    char buffer[64];
+    for(int i=0;i<20000;i++) {
+        auto x = cbRandomDouble();
+        snprintf(buffer, sizeof(buffer), "%.17g", x);
+        TR_ASSERT(t, SameAsFromChars<double>(buffer));
+        snprintf(buffer, sizeof(buffer), "%.*e", static_cast<int>(rng() % 25), x);
+        TR_ASSERT(t, SameAsFromChars<double>(buffer));
+        TR_ASSERT(t, SameAsFromChars<float>(buffer));
+        auto f = cbRandomFloat();
+        snprintf(buffer, sizeof(buffer), "%.9g", f);
+        TR_ASSERT(t, SameAsFromChars<float>(buffer));
+    }
+
+    // random digit strings, up to 60 digits with random decimal point and exponent
+    for(int i=0;i<20000;i++) {
+        std::string str = (rng() & 1) ? "-" : "";
+        auto nDigits = 1 + rng() % 60;
+        auto idxDot = rng() % (nDigits + 1);
+        for(size_t d=0;d<nDigits;d++) {
+            if (d == idxDot) str += ".";
+            str.push_back(static_cast<char>('0' + rng() % 10));
+        }
+        str += "e" + std::to_string(static_cast<int>(rng() % 740) - 370);
+        TR_ASSERT(t, SameAsFromChars<double>(str));
+        TR_ASSERT(t, SameAsFromChars<float>(str));
+    }
+
+    // exactly halfway and just around it - only the exact slow path can decide these
+    TR_ASSERT(t, SameAsFromChars<double>(HalfwayString(0.0, 0)));
+    TR_ASSERT(t, SameAsFromChars<double>(HalfwayString(0.0, 1)));
+    TR_ASSERT(t, SameAsFromChars<double>(HalfwayString(std::numeric_limits<double>::max(), 0)));
+    TR_ASSERT(t, SameAsFromChars<double>(HalfwayString(std::numeric_limits<double>::max(), -1)));
+    TR_ASSERT(t, SameAsFromChars<float>(HalfwayString(std::numeric_limits<float>::max(), 0)));
+    TR_ASSERT(t, SameAsFromChars<float>(HalfwayString(std::numeric_limits<float>::denorm_min(), 0)));
+    for(int i=0;i<300;i++) {
+        auto x = std::fabs(cbRandomDouble());
+        if (x == std::numeric_limits<double>::max()) continue;
+        for(int nudge=-1;nudge<=1;nudge++) {
+            TR_ASSERT(t, SameAsFromChars<double>(HalfwayString(x, nudge)));
+        }
+        auto f = std::fabs(cbRandomFloat());
+        if (f == std::numeric_limits<float>::max()) continue;
+        for(int nudge=-1;nudge<=1;nudge++) {
+            TR_ASSERT(t, SameAsFromChars<float>(HalfwayString(f, nudge)));
+        }
+    }
+
+    // integers, every width against from_chars
+    auto cbSameInteger = [](auto dummy, const std::string &str) {
+        using T = decltype(dummy);
+        T expected = 7, actual = 7;
+        auto r = std::from_chars(str.data(), str.data() + str.size(), expected);
+        auto ecExpected = ((r.ec == std::errc{}) && (r.ptr != str.data() + str.size())) ? std::errc::invalid_argument : r.ec;
+        auto ecActual = ArgNumberParser::ParseInteger(str.data(), str.data() + str.size(), actual);
+        return (ecExpected == ecActual) && ((ecActual != std::errc{}) || (expected == actual));
+    };
+    for(int i=0;i<20000;i++) {
+        std::string str = ((rng() % 4) == 0) ? "-" : "";
+        auto nDigits = 1 + rng() % 22;
+        for(size_t d=0;d<nDigits;d++) {
+            str.push_back(static_cast<char>('0' + rng() % 10));
+        }
+        TR_ASSERT(t, cbSameInteger(int8_t{}, str));
+        TR_ASSERT(t, cbSameInteger(uint16_t{}, str));
+        TR_ASSERT(t, cbSameInteger(int32_t{}, str));
+        TR_ASSERT(t, cbSameInteger(uint32_t{}, str));
+        TR_ASSERT(t, cbSameInteger(int64_t{}, str));
+        TR_ASSERT(t, cbSameInteger(uint64_t{}, str));
+    }
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_static(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "-vx",
+        "--threads",
+        "8",
+        "--input",
+        "in1",
+        "in2",
+        "in3",
+        "--ids=1,2,3",
+        "--level",
+        "high",
+        "--name",
+        "SomeName",
+        "end1",
+        "end2",
+        NULL,
+    };
+    StaticArgParser<4, 16> argParser(15, argv);
+    TR_ASSERT(t, argParser.IsValid());
+
+    // nothing below allocates, all results are fixed size or views into argv
+    auto nBefore = glb_nAllocations.load();
+    TR_ASSERT(t, argParser.IsPresent("-v", "--verbose"));
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, argParser.TryParse(std::string_view{}, "-n", "--name") == "SomeName");
+
+    std::array<std::string_view, 4> inputs;
+    TR_ASSERT(t, argParser.TryParse(std::span(inputs), "-i", "--input") == 3);
+    TR_ASSERT(t, inputs[2] == "in3");
+
+    std::array<int, 3> ids = {};
+    TR_ASSERT(t, argParser.TryParseList(std::span(ids), "-d", "--ids") == 3);
+    TR_ASSERT(t, ids[2] == 3);
+
+    auto level = argParser.Parse<int>("-l", "--level");
+    TR_ASSERT(t, !level);
+    TR_ASSERT(t, level.error().kind == ArgParser::kParseResult::ErrArgTypeError);
+    TR_ASSERT(t, level.error().idxArg == 10);
+
+    std::array<std::string_view, 4> endArgs;
+    TR_ASSERT(t, argParser.CopyEndArgs(std::span(endArgs)) == 2);
+    TR_ASSERT(t, endArgs[1] == "end2");
+
+    // '-x' and '--level high' were never used
+    std::array<std::string_view, 8> unconsumed;
+    TR_ASSERT(t, argParser.Unconsumed(std::span(unconsumed)) == 3);
+    TR_ASSERT(t, unconsumed[0] == "-vx");
+    TR_ASSERT(t, unconsumed[1] == "--level");
+    TR_ASSERT(t, glb_nAllocations == nBefore);
+
+    // storage too small is an error, not a truncation
+    std::array<std::string_view, 2> tooSmall;
+    TR_ASSERT(t, argParser.TryParse(std::span(tooSmall), "-i", "--input") == -1);
+    TR_ASSERT(t, argParser.Unconsumed(std::span(tooSmall)) == -1);
+
+    // more flags than table slots, the extra ones are marked directly
+    const char *argvFlags[]= { "prgname.exe", "--a", "--b", "--c", "--d", "--e", "--f", "--a", NULL };
+    StaticArgParser<2, 16> flagParser(8, argvFlags);
+    for(auto name : {"--a", "--b", "--c", "--d", "--e"}) {
+        TR_ASSERT(t, flagParser.IsPresent("-?", name));
+    }
+    TR_ASSERT(t, flagParser.Unconsumed(std::span(unconsumed)) == 1);
+    TR_ASSERT(t, unconsumed[0] == "--f");
+
+    // too many arguments are cut off and reported through IsValid
+    StaticArgParser<4, 4> smallParser(15, argv);
+    TR_ASSERT(t, !smallParser.IsValid());
+    TR_ASSERT(t, smallParser.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, !smallParser.IsPresent("-n", "--name"));
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_environment(ITesting *t) {
+    const char *argv[]= {
+        "prgname.exe",
+        "--threads", "8",
+        "--port=x",
+        NULL,
+    };
+    const char *envp[]= {
+        "APP_THREADS=2",
+        "APP_ROOT=/srv/data",
+        "APP_CACHE=64K",
+        "APP_RATIO=abc",
+        "APP_EMPTY=",
+        "APP_ROOT=/second/definition",
+        "NO_SEPARATOR",
+        "=no_name",
+        NULL,
+    };
+    ArgParser argParser(4, argv);
+    DiagnosticsLog log;
+    argParser.SetDiagnostics(DiagnosticsLog::Report, &log);
+    argParser.SetEnvironment(envp);
+
+    // the command line wins over the environment
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads", ArgEnv("APP_THREADS")) == 8);
+    // not on the command line, from the environment - a slice of the environment string, the first definition wins
+    auto root = argParser.TryParse(std::string_view("/"), "-r", "--root", ArgEnv("APP_ROOT"));
+    TR_ASSERT(t, root == "/srv/data");
+    TR_ASSERT(t, root->data() == envp[1] + 9);
+    TR_ASSERT(t, argParser.TryParse<ArgByteSize>("-c", "--cache", ArgEnv("APP_CACHE"))->bytes == 64 * 1024);
+    TR_ASSERT(t, argParser.TryParse(std::string_view("x"), "-e", "--empty", ArgEnv("APP_EMPTY")) == "");
+    // neither, the default
+    TR_ASSERT(t, argParser.TryParse(3, "-l", "--level", ArgEnv("APP_LEVEL")) == 3);
+    TR_ASSERT(t, argParser.TryParse(3, "-l", "--level", ArgEnv("NO_SEPARATOR")) == 3);
+    TR_ASSERT(t, log.nErrors == 0);
+
+    // an invalid value in the environment is reported with the variable name
+    TR_ASSERT(t, !argParser.TryParse(0.5, "-q", "--ratio", ArgEnv("APP_RATIO")).has_value());
+    TR_ASSERT(t, log.nErrors == 1);
+    TR_ASSERT(t, log.errors[0].idxArg == ArgParser::ArgError::kEnvironment);
+    TR_ASSERT(t, log.errors[0].option == "APP_RATIO");
+    // an invalid value on the command line is not replaced by the environment
+    TR_ASSERT(t, !argParser.TryParse(80, "-p", "--port", ArgEnv("APP_THREADS")).has_value());
+
+    // the index is kept over Reset
+    argParser.Reset(1, argv);
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads", ArgEnv("APP_THREADS")) == 2);
+
+    // without an explicit environment the process environment is indexed on first use
+    setenv("ARGPARSER_TEST_THREADS", "12", 1);
+    ArgParser processParser(1, argv);
+    TR_ASSERT(t, processParser.TryParse(1, "-t", "--threads", ArgEnv("ARGPARSER_TEST_THREADS")) == 12);
+    unsetenv("ARGPARSER_TEST_THREADS");
+
+    // the index on its own, many variables
+    std::vector<std::string> strings;
+    for(int i=0;i<1000;i++) {
+        strings.push_back("VAR_" + std::to_string(i) + "=" + std::to_string(i * 3));
+    }
+    std::vector<const char *> bigEnv;
+    for(auto &s : strings) {
+        bigEnv.push_back(s.c_str());
+    }
+    bigEnv.push_back(nullptr);
+    ArgEnvironment environment;
+    TR_ASSERT(t, !environment.IsBuilt());
+    environment.Build(bigEnv.data());
+    for(int i=0;i<1000;i++) {
+        TR_ASSERT(t, environment.Find("VAR_" + std::to_string(i)) == std::to_string(i * 3));
+    }
+    TR_ASSERT(t, !environment.Find("VAR_1000").has_value());
+    TR_ASSERT(t, !environment.Find("VAR_").has_value());
+    TR_ASSERT(t, !environment.Find("").has_value());
+
+    return kTR_Pass;
+}
+
+static bool WriteTempFile(char *filename, std::string_view content) {
+    int fd = mkstemp(filename);
+    if (fd < 0) {
+        return false;
+    }
+    bool bOk = (write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+    close(fd);
+    return bOk;
+}
+
+extern "C" int test_argparser_config(ITesting *t) {
+    char filename[] = "/tmp/argparser_cfgXXXXXX";
+    TR_ASSERT(t, WriteTempFile(filename,
+        "# defaults for the service\n"
+        "threads = 2\n"
+        "  root=/srv/data  \r\n"
+        "name = \"  spaced name \"\n"
+        "verbose = true\n"
+        "quiet = false\n"
+        "ratio = abc\n"
+        "empty =\n"
+        "; other comment\n"
+        "threads = 6\n"
+        "[server]\n"
+        "port = 8080\n"
+        "[ tls ]\n"
+        "cert = 'server.pem'\n"
+        "[a.b]\n"
+        "c = section\n"
+        "[]\n"
+        "a.b.c = top level\n"
+        "last = no newline"));
+
+    ArgConfigFile configFile;
+    TR_ASSERT(t, configFile.Open(filename));
+    TR_ASSERT(t, configFile.Count() == 13);
+    TR_ASSERT(t, configFile.Find("threads") == "6");
+    TR_ASSERT(t, configFile.Find("root") == "/srv/data");
+    TR_ASSERT(t, configFile.Find("name") == "  spaced name ");
+    TR_ASSERT(t, configFile.Find("empty") == "");
+    TR_ASSERT(t, configFile.Find("server.port") == "8080");
+    TR_ASSERT(t, configFile.Find("tls.cert") == "server.pem");
+    TR_ASSERT(t, configFile.Find("port") == std::nullopt);
+    // same full name through a section and a dotted key, the last one wins
+    TR_ASSERT(t, configFile.Find("a.b.c") == "top level");
+    TR_ASSERT(t, configFile.Find("last") == "no newline");
+
+    const char *argv[]= {
+        "prgname.exe",
+        "--threads", "8",
+        NULL,
+    };
+    const char *envp[]= {
+        "APP_ROOT=/env/root",
+        NULL,
+    };
+    ArgParser argParser(3, argv);
+    DiagnosticsLog log;
+    argParser.SetDiagnostics(DiagnosticsLog::Report, &log);
+    argParser.SetEnvironment(envp);
+    TR_ASSERT(t, argParser.LoadConfig(filename));
+    unlink(filename);
+
+    // file < env < argv
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, argParser.TryParse(std::string_view("/"), "-r", "--root", ArgEnv("APP_ROOT")) == "/env/root");
+    TR_ASSERT(t, argParser.TryParse(std::string_view("/"), "-r", "--root", ArgEnv("APP_NO_ROOT")) == "/srv/data");
+    TR_ASSERT(t, argParser.TryParse(std::string_view("/"), "-r", "--root") == "/srv/data");
+    TR_ASSERT(t, argParser.TryParse(80, "-p", "--server.port") == 8080);
+    TR_ASSERT(t, argParser.Parse<int>("-p", "--server.port").value_or(0) == 8080);
+    TR_ASSERT(t, argParser.TryParse(std::string("x"), "-n", "--name") == "  spaced name ");
+    TR_ASSERT(t, argParser.IsPresent("-v", "--verbose"));
+    TR_ASSERT(t, !argParser.IsPresent("-q", "--quiet"));
+    TR_ASSERT(t, argParser.TryParse(3, "-l", "--level") == 3);
+    TR_ASSERT(t, log.nErrors == 0);
+
+    // a snapshot falls back to the same layers
+    const auto snapshot = argParser.Freeze();
+    TR_ASSERT(t, snapshot.TryParse(1, "-t", "--threads") == 8);
+    TR_ASSERT(t, snapshot.TryParse(std::string_view("/"), "-r", "--root", ArgEnv("APP_ROOT")) == "/env/root");
+    TR_ASSERT(t, snapshot.TryParse(std::string_view("/"), "-r", "--root") == "/srv/data");
+    TR_ASSERT(t, snapshot.TryParse<int>("-p", "--server.port") == 8080);
+    TR_ASSERT(t, snapshot.Parse(80, "-p", "--server.port").value_or(0) == 8080);
+    TR_ASSERT(t, snapshot.IsPresent("-v", "--verbose"));
+    TR_ASSERT(t, !snapshot.IsPresent("-q", "--quiet"));
+
+    // an invalid value in the file is reported with the key
+    TR_ASSERT(t, !argParser.TryParse(0.5, "", "--ratio").has_value());
+    auto ratio = argParser.Parse<double>("", "--ratio");
+    TR_ASSERT(t, !ratio);
+    TR_ASSERT(t, ratio.error().idxArg == ArgParser::ArgError::kConfig);
+    TR_ASSERT(t, ratio.error().option == "ratio");
+    TR_ASSERT(t, log.nErrors == 2);
+
+    // malformed files are rejected with the line
+    char badname[] = "/tmp/argparser_cfgXXXXXX";
+    TR_ASSERT(t, WriteTempFile(badname, "a = 1\n\n  no separator here\n"));
+    ArgConfigFile badFile;
+    TR_ASSERT(t, !badFile.Open(badname));
+    TR_ASSERT(t, badFile.ErrorLine() == 3);
+    TR_ASSERT(t, !argParser.LoadConfig(badname));
+    unlink(badname);
+    char badsection[] = "/tmp/argparser_cfgXXXXXX";
+    TR_ASSERT(t, WriteTempFile(badsection, "[section\n"));
+    TR_ASSERT(t, !badFile.Open(badsection));
+    TR_ASSERT(t, badFile.ErrorLine() == 1);
+    unlink(badsection);
+    TR_ASSERT(t, !badFile.Open("/nonexisting/config.ini"));
+    TR_ASSERT(t, badFile.ErrorLine() == 0);
+    // the previous config is kept
+    TR_ASSERT(t, argParser.TryParse(80, "-p", "--server.port") == 8080);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_subcommands(ITesting *t) {
+    using Commands = ArgSubcommands<"add", "commit", "re", "rebase", "remote", "reset", "cherry-pick", "a">;
+    static_assert(Commands::IndexOf<"remote">() == 4);
+
+    TR_ASSERT(t, Commands::Lookup("add") == 0);
+    TR_ASSERT(t, Commands::Lookup("commit") == 1);
+    TR_ASSERT(t, Commands::Lookup("re") == 2);
+    TR_ASSERT(t, Commands::Lookup("rebase") == 3);
+    TR_ASSERT(t, Commands::Lookup("remote") == 4);
+    TR_ASSERT(t, Commands::Lookup("reset") == 5);
+    TR_ASSERT(t, Commands::Lookup("cherry-pick") == 6);
+    TR_ASSERT(t, Commands::Lookup("a") == 7);
+    TR_ASSERT(t, Commands::Lookup("") == -1);
+    TR_ASSERT(t, Commands::Lookup("r") == -1);
+    TR_ASSERT(t, Commands::Lookup("reb") == -1);
+    TR_ASSERT(t, Commands::Lookup("commits") == -1);
+    TR_ASSERT(t, Commands::Lookup("comm") == -1);
+    TR_ASSERT(t, Commands::Lookup("cherry-picK") == -1);
+    TR_ASSERT(t, Commands::Lookup("b") == -1);
+
+    const char *argv[]= {
+        "tool",
+        "-C", "path",
+        "-v",
+        "commit",
+        "-m", "message",
+        "--amend",
+        "--",
+        "file1",
+        NULL,
+    };
+    ArgParser argParser(10, argv);
+    argParser.SetStopCondition("--");
+    // the value of a global option is not taken for the command
+    TR_ASSERT(t, argParser.TryParse(std::string_view("."), "-C") == "path");
+    auto match = Commands::Find(argParser);
+    TR_ASSERT(t, match.IsValid());
+    TR_ASSERT(t, match.idxCommand == Commands::IndexOf<"commit">());
+    TR_ASSERT(t, match.idxArg == 4);
+
+    int nCalls = 0;
+    auto cbOther = [&nCalls](ArgParser &) { nCalls++; return 1; };
+    auto cbCommit = [&](ArgParser &args) -> int {
+        nCalls++;
+        // the slice points into argv, nothing is copied
+        auto msg = args.TryParse<std::string_view>("-m", "--message");
+        TR_ASSERT(t, msg.has_value() && (msg->data() == argv[6]));
+        TR_ASSERT(t, args.IsPresent("-a", "--amend"));
+        // the stop condition is inherited
+        TR_ASSERT(t, !args.IsPresent("file1"));
+        std::vector<std::string> files;
+        TR_ASSERT(t, args.CopyEndArgs(files) == 1);
+        TR_ASSERT(t, files[0] == "file1");
+        std::vector<std::string_view> unconsumed;
+        TR_ASSERT(t, args.Unconsumed(unconsumed) == 0);
+        // and can be changed per level
+        args.SetStopCondition("--amend");
+        TR_ASSERT(t, !args.IsPresent("-a", "--amend"));
+        return 42;
+    };
+    auto exitCode = Commands::Dispatch(argParser, cbOther, cbCommit, cbOther, cbOther, cbOther, cbOther, cbOther, cbOther);
+    TR_ASSERT(t, exitCode == 42);
+    TR_ASSERT(t, nCalls == 1);
+    TR_ASSERT(t, argParser.IsPresent("-v"));
+    // the parent still stops at its own stop condition
+    TR_ASSERT(t, !argParser.IsPresent("file1"));
+    std::vector<std::string_view> unconsumed;
+    argParser.Unconsumed(unconsumed);
+    TR_ASSERT(t, std::find(unconsumed.begin(), unconsumed.end(), "commit") == unconsumed.end());
+
+    // nested levels, like 'remote add <name> <url>'
+    const char *argv_nested[]= {
+        "tool",
+        "remote",
+        "-v",
+        "add",
+        "origin",
+        "url",
+        NULL,
+    };
+    using RemoteCommands = ArgSubcommands<"add", "remove">;
+    ArgParser nestedParser(6, argv_nested);
+    auto nestedExit = Commands::Dispatch(nestedParser, cbOther, cbOther, cbOther, cbOther,
+        [&](ArgParser &remoteArgs) -> int {
+            TR_ASSERT(t, remoteArgs.IsPresent("-v", "--verbose"));
+            return RemoteCommands::Dispatch(remoteArgs,
+                [&](ArgParser &addArgs) -> int {
+                    std::vector<std::string> values;
+                    TR_ASSERT(t, addArgs.CopyEndArgs(values) == 2);
+                    TR_ASSERT(t, (values[0] == "origin") && (values[1] == "url"));
+                    return 7;
+                },
+                cbOther).value_or(-1);
+        },
+        cbOther, cbOther, cbOther);
+    TR_ASSERT(t, nestedExit == 7);
+
+    // no command, an unknown command and a command after the stop condition
+    const char *argv_unknown[]= {
+        "tool",
+        "-v",
+        "comit",
+        "--",
+        "commit",
+        NULL,
+    };
+    ArgParser unknownParser(5, argv_unknown);
+    unknownParser.SetStopCondition("--");
+    auto unknown = Commands::Find(unknownParser);
+    TR_ASSERT(t, !unknown.IsValid());
+    TR_ASSERT(t, unknown.idxArg == 2);
+    nCalls = 0;
+    TR_ASSERT(t, !Commands::Dispatch(unknownParser, cbOther, cbOther, cbOther, cbOther, cbOther, cbOther, cbOther, cbOther).has_value());
+    TR_ASSERT(t, nCalls == 0);
+
+    ArgParser stoppedParser(5, argv_unknown);
+    stoppedParser.SetStopCondition("comit");
+    auto stopped = Commands::Find(stoppedParser);
+    TR_ASSERT(t, !stopped.IsValid());
+    TR_ASSERT(t, stopped.idxArg == 5);
+
+    return kTR_Pass;
+}
+
+extern "C" int test_argparser_completion(ITesting *t) {
+    ArgCompletion completion;
+    completion.Flag("-v", "--verbose")
+              .Flag("-x")
+              .Value("-t", "--threads")
+              .Value("-n", "--name")
+              .Value("", "--thread-pool")
+              .Flag("", "--through");
+    using Schema = ArgSchema<ArgOption<"-o", "--output", std::string>,
+                             ArgOption<"-q", "--quiet", bool>>;
+    Schema::Register(completion);
+    completion.SetStopCondition("--");
+    TR_ASSERT(t, completion.Count() == 13);
+
+    auto cbComplete = [&completion](std::initializer_list<const char *> words) {
+        std::vector<std::string_view> candidates;
+        completion.Complete(std::span<const char *const>(words.begin(), words.size()), candidates);
+        return candidates;
+    };
+
+    auto candidates = cbComplete({"tool", "--th"});
+    TR_ASSERT(t, candidates.size() == 3);
+    TR_ASSERT(t, (candidates[0] == "--thread-pool") && (candidates[1] == "--threads") && (candidates[2] == "--through"));
+    TR_ASSERT(t, cbComplete({"tool", "--thread"}).size() == 2);
+    TR_ASSERT(t, cbComplete({"tool", "--threads"}).size() == 1);
+    TR_ASSERT(t, cbComplete({"tool", "--o"}).size() == 1);
+    TR_ASSERT(t, cbComplete({"tool", "--nothing"}).empty());
+    // short and long names
+    TR_ASSERT(t, cbComplete({"tool", "-"}).size() == 13);
+    TR_ASSERT(t, cbComplete({"tool", "--"}).size() == 7);
+    // not an option, an attached value or nothing at all
+    TR_ASSERT(t, cbComplete({"tool", ""}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "file"}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "--name=--th"}).empty());
+    TR_ASSERT(t, cbComplete({"tool"}).empty());
+
+    // values are not offered options
+    TR_ASSERT(t, cbComplete({"tool", "--threads", "--th"}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "-t", "-"}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "-o", "-"}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "-vn", "-"}).empty());
+    TR_ASSERT(t, cbComplete({"tool", "--threads", "8", "--th"}).size() == 3);
+    TR_ASSERT(t, cbComplete({"tool", "--threads=8", "--th"}).size() == 3);
+    TR_ASSERT(t, cbComplete({"tool", "-t8", "--th"}).size() == 3);
+    TR_ASSERT(t, cbComplete({"tool", "-nv", "--th"}).size() == 3);
+    TR_ASSERT(t, cbComplete({"tool", "-vx", "--th"}).size() == 3);
+    TR_ASSERT(t, cbComplete({"tool", "-q", "--th"}).size() == 3);
+    // the value of an option is taken even if it looks like the stop condition
+    TR_ASSERT(t, cbComplete({"tool", "-t", "--", "--th"}).size() == 3);
+    // nothing after the stop condition
+    TR_ASSERT(t, cbComplete({"tool", "-v", "--", "--th"}).empty());
+
+    // completion mode
+    const char *argv[]= {
+        "tool",
+        "--__complete",
+        "tool",
+        "-v",
+        "--thr",
+        NULL,
+    };
+    auto out = tmpfile();
+    TR_ASSERT(t, completion.Run(5, argv, out));
+    char buffer[64] = {};
+    rewind(out);
+    auto nRead = fread(buffer, 1, sizeof(buffer) - 1, out);
+    fclose(out);
+    TR_ASSERT(t, std::string_view(buffer, nRead) == "--thread-pool\n--threads\n--through\n");
+    TR_ASSERT(t, !completion.Run(3, &argv[2], stdout));
+
+    // names registered out of order are sorted once
+    ArgCompletion generated;
+    for(int i=999;i>=0;i--) {
+        generated.Flag("", "--metric-" + std::to_string(i));
+    }
+    TR_ASSERT(t, cbComplete({"tool", "--metric-99"}).empty());
+    std::vector<std::string_view> metrics;
+    const char *words[] = {"tool", "--metric-99"};
+    TR_ASSERT(t, generated.Complete(words, metrics) == 11);
+    TR_ASSERT(t, (metrics[0] == "--metric-99") && (metrics[1] == "--metric-990") && (metrics[10] == "--metric-999"));
+
+    return kTR_Pass;
+}
+
+static size_t EditDistanceReference(std::string_view a, std::string_view b) {
+    std::vector<size_t> prev(b.length() + 1), cur(b.length() + 1);
+    for(size_t j=0;j<prev.size();j++) {
+        prev[j] = j;
+    }
+    for(size_t i=0;i<a.length();i++) {
+        cur[0] = i + 1;
+        for(size_t j=0;j<b.length();j++) {
+            cur[j + 1] = std::min({prev[j] + ((a[i] == b[j]) ? 0 : 1), prev[j + 1] + 1, cur[j] + 1});
+        }
+        std::swap(prev, cur);
+    }
+    return prev.back();
+}
+
+extern "C" int test_argparser_suggest(ITesting *t) {
+    ArgEditDistance threads("--threads");
+    TR_ASSERT(t, threads.Distance("--threads", 2) == 0);
+    TR_ASSERT(t, threads.Distance("--thread", 2) == 1);
+    TR_ASSERT(t, threads.Distance("--thraeds", 2) == 2);
+    TR_ASSERT(t, threads.Distance("--tread", 2) == 2);
+    TR_ASSERT(t, threads.Distance("--verbose", 2) == 3);
+    TR_ASSERT(t, threads.Distance("--threads-and-more", 2) == 3);
+    TR_ASSERT(t, threads.Distance("", 20) == 9);
+    TR_ASSERT(t, ArgEditDistance("").Distance("-v", 2) == 2);
+
+    // the bit-parallel kernel (and the fallback above 64 characters) against the plain dynamic program
+    std::mt19937 rng(4711);
+    auto cbRandom = [&rng](size_t length) {
+        std::string str;
+        for(size_t i=0;i<length;i++) {
+            str.push_back("-abcde"[rng() % 6]);
+        }
+        return str;
+    };
+    for(int i=0;i<2000;i++) {
+        auto pattern = cbRandom(1 + rng() % ((i < 1800) ? 64 : 80));
+        auto text = (rng() & 1) ? cbRandom(rng() % 80) : pattern;
+        // a few random edits of the pattern
+        for(int nEdits = rng() % 4;(nEdits > 0) && !text.empty();nEdits--) {
+            text[rng() % text.size()] = "-abcde"[rng() % 6];
+        }
+        ArgEditDistance editDistance(pattern);
+        auto expected = EditDistanceReference(pattern, text);
+        for(size_t maxDistance : {0, 1, 3, 100}) {
+            auto distance = editDistance.Distance(text, maxDistance);
+            TR_ASSERT(t, distance == std::min(expected, maxDistance + 1));
+        }
+    }
+
+    ArgCompletion completion;
+    completion.Flag("-v", "--verbose")
+              .Value("-t", "--threads")
+              .Value("", "--thread-pool")
+              .Flag("", "--through")
+              .Value("-o", "--output");
+    std::vector<std::string_view> names;
+    TR_ASSERT(t, completion.Suggest("--thraeds", names) == 1);
+    TR_ASSERT(t, names[0] == "--threads");
+    names.clear();
+    TR_ASSERT(t, completion.Suggest("--throuh", names, 4) == 2);
+    TR_ASSERT(t, (names[0] == "--through") && (names[1] == "--threads"));
+    names.clear();
+    // the attached value is not part of the comparison
+    TR_ASSERT(t, completion.Suggest("--ouptut=file", names, 1) == 0);
+    TR_ASSERT(t, completion.Suggest("--ouptut=file", names) == 1);
+    TR_ASSERT(t, names[0] == "--output");
+    names.clear();
+    TR_ASSERT(t, completion.Suggest("--verbos", names, 1) == 1);
+    TR_ASSERT(t, names[0] == "--verbose");
+    names.clear();
+    TR_ASSERT(t, completion.Suggest("--something-else", names) == 0);
+    TR_ASSERT(t, completion.Suggest("-x", names, 1) == 3);
+    TR_ASSERT(t, (names[0] == "-o") && (names[1] == "-t") && (names[2] == "-v"));
+
+    // unknown options from the parser
+    const char *argv[]= {
+        "tool",
+        "--thread", "4",
+        "-v",
+        NULL,
+    };
+    ArgParser argParser(4, argv);
+    TR_ASSERT(t, argParser.IsPresent("-v", "--verbose"));
+    TR_ASSERT(t, argParser.TryParse(1, "-t", "--threads") == 1);
+    std::vector<std::string_view> unknown;
+    TR_ASSERT(t, argParser.Unconsumed(unknown) == 2);
+    names.clear();
+    TR_ASSERT(t, completion.Suggest(unknown[0], names) == 1);
+    TR_ASSERT(t, names[0] == "--threads");
+
+    return kTR_Pass;
+}